@@ -203,6 +203,53 @@ config_string(
     DEFAULT 5
     UNQUOTE
 )
+config_option(
+    KernelThreadTimeSlice THREAD_TIME_SLICE
+    "Allow the time slice of each thread to be set with seL4_TCB_SetTimeSlice. Threads \
+    start with a time slice of KernelTimeSlice ticks."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+config_option(
+    KernelThreadBudgets THREAD_BUDGETS
+    "Allow a thread to be limited to a budget of timer ticks in every period with \
+    seL4_TCB_SetBudget. A thread that exhausts its budget is removed from the ready \
+    queues until the budget is replenished at the end of the period, so that a high \
+    priority thread cannot starve lower priority ones. Threads are not limited by default."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+config_option(
+    KernelPriorityInheritance PRIORITY_INHERITANCE
+    "Allow a server thread to be marked with seL4_TCB_SetPriorityInheritance so that it \
+    runs at the priority of a higher priority thread that calls it over an endpoint \
+    until it replies or waits to receive again. This bounds the priority inversion of \
+    a client blocked on a lower priority server."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+# Timers that can be programmed with an absolute deadline
+if(KernelArchX86 OR ("${CONFIGURE_TIMER}" STREQUAL "drivers/timer/arm_generic.h"))
+    set(KernelTimerHasDeadline ON)
+else()
+    set(KernelTimerHasDeadline OFF)
+endif()
+
+config_option(
+    KernelTickless TICKLESS
+    "Program the timer one-shot for the next tick that can cause a preemption (the end of \
+    the current thread's time slice or of the current domain) instead of interrupting \
+    every tick, and stop it while a core is idle. Time slices and domain lengths are \
+    still measured in KernelTimerTickMS ticks. On x86 this requires TSC-deadline mode \
+    support in the local APIC."
+    DEFAULT OFF
+    DEPENDS "KernelTimerHasDeadline;NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
 config_string(
     KernelRetypeFanOutLimit RETYPE_FAN_OUT_LIMIT
     "Maximum number of objects that can be created in a single Retype() invocation."
@@ -222,6 +269,13 @@ config_string(
     DEFAULT 8
     UNQUOTE
 )
+config_string(
+    KernelRangeFlushMaxPages RANGE_FLUSH_MAX_PAGES
+    "Maximum number of frames that a range unmap invalidates from the TLB one mapping at a time. \
+    Unmapping more frames invalidates every translation for the address space instead."
+    DEFAULT 32
+    UNQUOTE
+)
 config_string(
     KernelMaxNumBootinfoUntypedCaps MAX_NUM_BOOTINFO_UNTYPED_CAPS
     "Max number of bootinfo untyped caps"
@@ -229,6 +283,61 @@ config_string(
     UNQUOTE
 )
 config_option(KernelFastpath FASTPATH "Enable IPC fastpath" DEFAULT ON)
+config_option(
+    KernelSendFastpath SEND_FASTPATH
+    "Enable a fastpath for seL4_Send and seL4_NBSend on an endpoint that already has a \
+    receiver waiting. Messages with extra caps or longer than the message registers still \
+    take the slowpath."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath;NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+config_option(
+    KernelSignalFastpath SIGNAL_FASTPATH
+    "Enable a fastpath for seL4_Signal. This handles signalling an idle or active \
+    notification and waking the first thread waiting on the notification, switching \
+    to it directly if it has a higher priority than the signaller."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath;NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+config_option(
+    KernelFastpathCapTransfer FASTPATH_CAP_TRANSFER
+    "Allow seL4_Call and the send fastpath to transfer a single extra cap. This covers \
+    unwrapping the badge of a cap to the endpoint the message is sent on, and granting a \
+    cap into an empty receive slot. Anything that would not transfer in full still takes \
+    the slowpath."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath;NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+config_option(
+    KernelRecvFastpath RECV_FASTPATH
+    "Enable a fastpath for seL4_Recv, seL4_NBRecv and seL4_Wait when the receive can \
+    complete immediately: a signal is pending on the notification, or a sender with a \
+    short message and no caps is already queued on the endpoint."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath;NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+config_option(
+    KernelFastpathLongMessages FASTPATH_LONG_MESSAGES
+    "Allow the IPC fastpaths to transfer messages longer than the message registers. The \
+    remaining words are copied directly between the sender and receiver IPC buffers. A \
+    message that would be truncated because either IPC buffer is missing still takes the \
+    slowpath."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath;NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+config_option(
+    KernelVMFaultFastpath VM_FAULT_FASTPATH
+    "Enable a fastpath for delivering VM faults to a fault handler endpoint that already \
+    has a receiver waiting, and for the reply that restarts the faulting thread."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath;NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
 
 config_string(
     KernelNumDomains NUM_DOMAINS "The number of scheduler domains in the system"
@@ -244,6 +353,25 @@ find_file(
         to be linked with the kernel as a scheduling configuration."
 )
 
+config_option(
+    KernelRuntimeDomainSchedule RUNTIME_DOMAIN_SCHEDULE
+    "Allow the holder of the domain cap to replace the domain schedule at runtime with \
+    seL4_DomainSet_ScheduleConfigure and seL4_DomainSet_ScheduleInstall. The new \
+    schedule takes effect at the next domain boundary. The schedule from \
+    KernelDomainSchedule is used until then."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild;NOT ${KernelNumDomains} EQUAL 1"
+    DEFAULT_DISABLED OFF
+)
+
+config_string(
+    KernelMaxDomainScheduleLength MAX_DOMAIN_SCHEDULE_LENGTH
+    "Maximum number of entries in a domain schedule installed at runtime."
+    DEFAULT 256
+    DEPENDS "KernelRuntimeDomainSchedule" UNDEF_DISABLED
+    UNQUOTE
+)
+
 config_string(
     KernelNumPriorities NUM_PRIORITIES "The number of priority levels per domain. Valid range 1-256"
     DEFAULT 256
@@ -257,6 +385,93 @@ config_string(
     UNQUOTE
 )
 
+config_choice(
+    KernelLockAlgorithm
+    LOCK_ALGORITHM
+    "Queue lock algorithm used for the big kernel lock on SMP. \
+    clh -> CLH queue lock. Each handoff moves the lock's queue node between caches. \
+    mcs -> MCS queue lock. Each waiter spins on its own node, so a handoff only touches \
+    the cache line of the next waiter. \
+    ticket -> Ticket lock where waiters back off in proportion to their position in the \
+    queue, see KernelLockTicketBackoff. \
+    cohort -> NUMA-aware cohort lock that passes the lock to waiters on the same cluster \
+    of KernelLockCohortClusterSize cores before other clusters."
+    "clh;KernelLockCLH;LOCK_CLH"
+    "mcs;KernelLockMCS;LOCK_MCS;NOT KernelVerificationBuild;NOT ${KernelMaxNumNodes} EQUAL 1"
+    "ticket;KernelLockTicket;LOCK_TICKET;NOT KernelVerificationBuild;NOT ${KernelMaxNumNodes} EQUAL 1"
+    "cohort;KernelLockCohort;LOCK_COHORT;NOT KernelVerificationBuild;NOT ${KernelMaxNumNodes} EQUAL 1"
+)
+
+config_string(
+    KernelLockTicketBackoff LOCK_TICKET_BACKOFF
+    "Number of pause instructions a core waiting for the ticket lock executes per core \
+    ahead of it in the queue before polling the lock again."
+    DEFAULT 32
+    DEPENDS "KernelLockTicket" UNDEF_DISABLED
+    UNQUOTE
+)
+
+config_string(
+    KernelLockCohortClusterSize LOCK_COHORT_CLUSTER_SIZE
+    "Number of consecutive core indexes that share a cluster, usually a socket, in the \
+    cohort lock."
+    DEFAULT 8
+    DEPENDS "KernelLockCohort" UNDEF_DISABLED
+    UNQUOTE
+)
+
+config_string(
+    KernelLockCohortMaxHandoffs LOCK_COHORT_MAX_HANDOFFS
+    "Maximum number of times in a row the cohort lock is passed between cores of one \
+    cluster while cores of other clusters wait for it."
+    DEFAULT 64
+    DEPENDS "KernelLockCohort" UNDEF_DISABLED
+    UNQUOTE
+)
+
+config_option(
+    KernelFastpathCrossCore FASTPATH_CROSS_CORE
+    "Allow the IPC fastpaths to complete IPC between threads with different affinities \
+    instead of falling back to the slowpath. The woken thread is placed in the ready queue \
+    of its home core, which is sent a single reschedule IPI if it needs to preempt the \
+    thread running there."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath;NOT ${KernelMaxNumNodes} EQUAL 1"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelFastpathFineGrainedLocking FASTPATH_FINE_GRAINED_LOCKING
+    "Run the IPC fastpaths without the big kernel lock, locking only the endpoint or \
+    notification being operated on. IPC between threads on the same core then scales \
+    with the number of cores. IPC that crosses cores or transfers caps, and all other \
+    kernel entries, still take the big kernel lock, which waits for running fastpaths \
+    to finish."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath;NOT KernelVerificationBuild;NOT ${KernelMaxNumNodes} EQUAL 1;NOT KernelFastpathCrossCore;NOT KernelFastpathCapTransfer"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelWorkStealing WORK_STEALING
+    "Allow a core that has no runnable thread to take the highest priority thread \
+    marked as migratable with seL4_TCB_SetMigratable from the ready queue of another \
+    core that is busy. The stolen thread's affinity is changed to the stealing core."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild;NOT ${KernelMaxNumNodes} EQUAL 1"
+    DEFAULT_DISABLED OFF
+)
+
+config_string(
+    KernelWorkStealingPeriod WORK_STEALING_PERIOD
+    "Number of timer ticks an idle core waits between attempts to steal a thread from \
+    another core. A core always attempts to steal when it is about to become idle. \
+    Setting this to 0 disables the periodic attempts."
+    DEFAULT 10
+    DEPENDS "KernelWorkStealing" UNDEF_DISABLED
+    UNQUOTE
+)
+
 config_string(
     KernelStackBits KERNEL_STACK_BITS
     "This describes the log2 size of the kernel stack. Great care should be taken as\
@@ -320,12 +535,15 @@ config_choice(
     track_kernel_entries -> Log kernel entries information including timing, number of invocations and arguments for \
     system calls, interrupts, user faults and VM faults. \
     tracepoints -> Enable manually inserted tracepoints that the kernel will track time consumed between. \
-    track_utilisation -> Enable the kernel to track each thread's utilisation time."
+    track_utilisation -> Enable the kernel to track each thread's utilisation time. \
+    track_lock_contention -> Log how long each core waits for and holds the kernel lock, \
+    and the kernel entry the lock was held for."
     "none;KernelBenchmarksNone;NO_BENCHMARKS"
     "generic;KernelBenchmarksGeneric;BENCHMARK_GENERIC;NOT KernelVerificationBuild"
     "track_kernel_entries;KernelBenchmarksTrackKernelEntries;BENCHMARK_TRACK_KERNEL_ENTRIES;NOT KernelVerificationBuild"
     "tracepoints;KernelBenchmarksTracepoints;BENCHMARK_TRACEPOINTS;NOT KernelVerificationBuild"
     "track_utilisation;KernelBenchmarksTrackUtilisation;BENCHMARK_TRACK_UTILISATION;NOT KernelVerificationBuild"
+    "track_lock_contention;KernelBenchmarksTrackLockContention;BENCHMARK_TRACK_LOCK_CONTENTION;NOT KernelVerificationBuild;NOT ${KernelMaxNumNodes} EQUAL 1"
 )
 if(NOT (KernelBenchmarks STREQUAL "none"))
     config_set(KernelEnableBenchmarks ENABLE_BENCHMARKS ON)
@@ -343,7 +561,11 @@ config_string(
 )
 # TODO: this config has no business being in the build system, and should
 # be moved to C headers, but for now must be emulated here for compatibility
-if(KernelBenchmarksTrackKernelEntries OR KernelBenchmarksTracepoints)
+if(
+    KernelBenchmarksTrackKernelEntries
+    OR KernelBenchmarksTracepoints
+    OR KernelBenchmarksTrackLockContention
+)
     config_set(KernelBenchmarkUseKernelLogBuffer BENCHMARK_USE_KERNEL_LOG_BUFFER ON)
 else()
     config_set(KernelBenchmarkUseKernelLogBuffer BENCHMARK_USE_KERNEL_LOG_BUFFER OFF)
@@ -413,6 +635,15 @@ config_option(
     DEPENDS "KernelArchX86 OR KernelPlatformHikey"
 )
 
+config_option(
+    KernelBatchInvocations BATCH_INVOCATIONS
+    "Adds the seL4_CallBatch system call, which performs a sequence of object invocations \
+    described in the IPC buffer in a single kernel entry. The kernel may be preempted \
+    between invocations and resumes the batch where it stopped."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+)
+
 # Builds the kernel with support for an invocation to set the TLS_BASE
 # of the currently running thread without a capability.
 config_set(KernelSetTLSBaseSelf SET_TLS_BASE_SELF ${KernelSetTLSBaseSelf})
@@ -25,8 +25,26 @@ exception_t handleUnknownSyscall(word_t w);
 exception_t handleUserLevelFault(word_t w_a, word_t w_b);
 exception_t handleVMFaultEvent(vm_fault_type_t vm_faultType);
 
+#ifdef CONFIG_BATCH_INVOCATIONS
+/* Arguments of the seL4_CallBatch record being decoded, or NULL, and
+ * their number */
+extern word_t *current_batch_args;
+extern word_t current_batch_length;
+#endif
+
 static inline word_t PURE getSyscallArg(word_t i, word_t *ipc_buffer)
 {
+#ifdef CONFIG_BATCH_INVOCATIONS
+    if (unlikely(current_batch_args != NULL)) {
+        /* Words past the record belong to the next record, or lie past
+         * the end of the IPC buffer */
+        if (unlikely(i >= current_batch_length)) {
+            return 0;
+        }
+        return current_batch_args[i];
+    }
+#endif
+
     if (i < n_msgRegisters) {
         return getRegister(NODE_STATE(ksCurThread), msgRegisters[i]);
     }
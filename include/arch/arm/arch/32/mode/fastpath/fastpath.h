@@ -115,7 +115,12 @@ static inline int fastpath_reply_cap_check(cap_t cap)
 /** DONT_TRANSLATE */
 static inline void NORETURN fastpath_restore(word_t badge, word_t msgInfo, tcb_t *cur_thread)
 {
-    NODE_UNLOCK;
+#ifdef CONFIG_HAVE_FPU
+    /* FPU state may only be saved with the lock held */
+    lazyFPURestore(NODE_STATE(ksCurThread));
+#endif /* CONFIG_HAVE_FPU */
+
+    NODE_UNLOCK_FASTPATH;
 
     c_exit_hook();
 
@@ -123,10 +128,6 @@ static inline void NORETURN fastpath_restore(word_t badge, word_t msgInfo, tcb_t
     restore_user_debug_context(NODE_STATE(ksCurThread));
 #endif
 
-#ifdef CONFIG_HAVE_FPU
-    lazyFPURestore(NODE_STATE(ksCurThread));
-#endif /* CONFIG_HAVE_FPU */
-
     register word_t badge_reg asm("r0") = badge;
     register word_t msgInfo_reg asm("r1") = msgInfo;
     register word_t cur_thread_reg asm("r2") = (word_t)cur_thread;
@@ -23,11 +23,13 @@
 #define CNT_TVAL CNTHP_TVAL
 #define CNT_CTL  CNTHP_CTL
 #define CNT_CVAL CNTHP_CVAL
+#define CNT_CT   CNTPCT
 #else
 /* Use virtual timer */
 #define CNT_TVAL CNTV_TVAL
 #define CNT_CTL  CNTV_CTL
 #define CNT_CVAL CNTV_CVAL
+#define CNT_CT   CNTVCT
 #endif
 
 #endif /* __ARCH_MODE_MACHINE_TIMER_H_ */
@@ -219,6 +219,21 @@ static inline void invalidateLocalTLB_VAASID(word_t mva_plus_asid)
     isb();
 }
 
+/* Invalidate 'count' consecutive translations of size BIT(pageBits) with a
+ * single pair of barriers. The operand holds the 4K page number in its low
+ * bits, so one invalidation is issued per translation, not per 4K page. */
+static inline void invalidateLocalTLB_VAASIDRange(word_t mva_plus_asid, word_t count, word_t pageBits)
+{
+    word_t i;
+
+    dsb();
+    for (i = 0; i < count; i++) {
+        asm volatile("tlbi vae1, %0" : : "r"(mva_plus_asid + (i << (pageBits - seL4_PageBits))));
+    }
+    dsb();
+    isb();
+}
+
 /* Invalidate all stage 1 and stage 2 translations used at
  * EL1 with the current VMID which is specified by vttbr_el2 */
 static inline void invalidateLocalTLB_VMALLS12E1(void)
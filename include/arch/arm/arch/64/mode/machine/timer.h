@@ -20,9 +20,13 @@
 #ifdef CONFIG_ARM_HYPERVISOR_SUPPORT
 #define CNT_TVAL "cnthp_tval_el2"
 #define CNT_CTL  "cnthp_ctl_el2"
+#define CNT_CVAL "cnthp_cval_el2"
+#define CNT_CT   "cntpct_el0"
 #else
 #define CNT_TVAL "cntv_tval_el0"
 #define CNT_CTL  "cntv_ctl_el0"
+#define CNT_CVAL "cntv_cval_el0"
+#define CNT_CT   "cntvct_el0"
 #endif
 #define CNTFRQ   "cntfrq_el0"
 
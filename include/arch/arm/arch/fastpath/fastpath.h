@@ -25,5 +25,20 @@ NORETURN SECTION(".vectors.fastpath_call");
 void fastpath_reply_recv(word_t cptr, word_t r_msgInfo)
 NORETURN SECTION(".vectors.fastpath_reply_recv");
 
+#if defined(CONFIG_SEND_FASTPATH) || defined(CONFIG_SIGNAL_FASTPATH)
+void fastpath_send(word_t cptr, word_t r_msgInfo, syscall_t syscall)
+NORETURN SECTION(".vectors.fastpath_send");
+#endif
+
+#ifdef CONFIG_RECV_FASTPATH
+void fastpath_recv(word_t cptr, word_t r_msgInfo, syscall_t syscall)
+NORETURN SECTION(".vectors.fastpath_recv");
+#endif
+
+#ifdef CONFIG_VM_FAULT_FASTPATH
+void fastpath_vm_fault(vm_fault_type_t type)
+NORETURN SECTION(".vectors.fastpath_vm_fault");
+#endif
+
 #endif /* __ARCH_FASTPATH_H */
 
@@ -56,4 +56,9 @@ exception_t decodeARMMMUInvocation(word_t invLabel, word_t length, cptr_t cptr,
 void Arch_userStackTrace(tcb_t *tptr);
 #endif
 
+/* TLB invalidations are not deferred, so there is nothing to complete */
+static inline void Arch_flushDeferredTranslations(void)
+{
+}
+
 #endif /* __ARCH_KERNEL_VSPACE_H */
@@ -37,6 +37,21 @@ static inline void invalidateTranslationASIDLocal(hw_asid_t hw_asid)
 #endif
 }
 
+#ifdef CONFIG_ARCH_AARCH64
+static inline void invalidateTranslationRangeLocal(vptr_t vptr, word_t count, word_t pageBits)
+{
+#ifdef CONFIG_ARM_HYPERVISOR_SUPPORT
+    word_t i;
+
+    for (i = 0; i < count; i++) {
+        invalidateLocalTLB_IPA_VMID(vptr + (i << (pageBits - seL4_PageBits)));
+    }
+#else
+    invalidateLocalTLB_VAASIDRange(vptr, count, pageBits);
+#endif
+}
+#endif /* CONFIG_ARCH_AARCH64 */
+
 static inline void invalidateTranslationAllLocal(void)
 {
     invalidateLocalTLB();
@@ -54,6 +69,14 @@ static inline void invalidateTranslationASID(hw_asid_t hw_asid)
     SMP_COND_STATEMENT(doRemoteInvalidateTranslationASID(hw_asid, MASK(CONFIG_MAX_NUM_NODES)));
 }
 
+#ifdef CONFIG_ARCH_AARCH64
+static inline void invalidateTranslationRange(vptr_t vptr, word_t count, word_t pageBits)
+{
+    invalidateTranslationRangeLocal(vptr, count, pageBits);
+    SMP_COND_STATEMENT(doRemoteInvalidateTranslationRange(vptr, count, pageBits, MASK(CONFIG_MAX_NUM_NODES)));
+}
+#endif /* CONFIG_ARCH_AARCH64 */
+
 static inline void invalidateTranslationAll(void)
 {
     invalidateTranslationAllLocal();
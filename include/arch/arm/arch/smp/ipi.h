@@ -20,8 +20,11 @@ typedef enum {
     IpiRemoteCall_Stall,
     IpiRemoteCall_InvalidateTranslationSingle,
     IpiRemoteCall_InvalidateTranslationASID,
+#ifdef CONFIG_ARCH_AARCH64
+    IpiRemoteCall_InvalidateTranslationRange,
+#endif
     IpiRemoteCall_InvalidateTranslationAll,
-    IpiRemoteCall_switchFpuOwner,
+    IpiRemoteCall_ReleaseFpuState,
     IpiRemoteCall_MaskPrivateInterrupt,
     /* Add relevant calls here upon required */
     IpiNumArchRemoteCall
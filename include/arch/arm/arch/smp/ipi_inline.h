@@ -23,9 +23,9 @@ static inline void doRemoteStall(word_t cpu)
 }
 
 #ifdef CONFIG_HAVE_FPU
-static inline void doRemoteswitchFpuOwner(user_fpu_state_t *new_owner, word_t cpu)
+static inline void doRemoteReleaseFpuState(user_fpu_state_t *state, word_t cpu)
 {
-    doRemoteOp1Arg(IpiRemoteCall_switchFpuOwner, (word_t)new_owner, cpu);
+    doRemoteOp1Arg(IpiRemoteCall_ReleaseFpuState, (word_t)state, cpu);
 }
 #endif /* CONFIG_HAVE_FPU */
 
@@ -39,6 +39,13 @@ static inline void doRemoteInvalidateTranslationASID(asid_t asid, word_t mask)
     doRemoteMaskOp1Arg(IpiRemoteCall_InvalidateTranslationASID, asid, mask);
 }
 
+#ifdef CONFIG_ARCH_AARCH64
+static inline void doRemoteInvalidateTranslationRange(vptr_t vptr, word_t count, word_t pageBits, word_t mask)
+{
+    doRemoteMaskOp3Arg(IpiRemoteCall_InvalidateTranslationRange, vptr, count, pageBits, mask);
+}
+#endif
+
 static inline void doRemoteInvalidateTranslationAll(word_t mask)
 {
     doRemoteMaskOp0Arg(IpiRemoteCall_InvalidateTranslationAll, mask);
@@ -48,5 +55,11 @@ static inline void doRemoteMaskPrivateInterrupt(word_t cpu, word_t disable, word
 {
     doRemoteOp2Arg(IpiRemoteCall_MaskPrivateInterrupt, disable, irq, cpu);
 }
+
+/* Acknowledging an interrupt does not need to wait for the target core */
+static inline void doRemoteAckPrivateInterrupt(word_t cpu, word_t irq)
+{
+    doRemoteOpAsync(IpiRemoteCall_MaskPrivateInterrupt, false, irq, 0, cpu);
+}
 #endif /* ENABLE_SMP_SUPPORT */
 #endif /* __ARCH_SMP_IPI_INLINE_H */
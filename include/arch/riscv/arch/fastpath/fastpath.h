@@ -37,6 +37,21 @@ NORETURN;
 void fastpath_reply_recv(word_t cptr, word_t r_msgInfo)
 NORETURN;
 
+#if defined(CONFIG_SEND_FASTPATH) || defined(CONFIG_SIGNAL_FASTPATH)
+void fastpath_send(word_t cptr, word_t r_msgInfo, syscall_t syscall)
+NORETURN;
+#endif
+
+#ifdef CONFIG_RECV_FASTPATH
+void fastpath_recv(word_t cptr, word_t r_msgInfo, syscall_t syscall)
+NORETURN;
+#endif
+
+#ifdef CONFIG_VM_FAULT_FASTPATH
+void fastpath_vm_fault(vm_fault_type_t type)
+NORETURN;
+#endif
+
 /* Use macros to not break verification */
 #define endpoint_ptr_get_epQueue_tail_fp(ep_ptr) TCB_PTR(endpoint_ptr_get_epQueue_tail(ep_ptr))
 #define cap_vtable_cap_get_vspace_root_fp(vtable_cap) PTE_PTR(cap_page_table_cap_get_capPTBasePtr(vtable_cap))
@@ -79,4 +79,9 @@ void setVMRoot(tcb_t *tcb);
 void Arch_userStackTrace(tcb_t *tptr);
 #endif
 
+/* TLB invalidations are not deferred, so there is nothing to complete */
+static inline void Arch_flushDeferredTranslations(void)
+{
+}
+
 #endif
@@ -97,8 +97,9 @@ static inline void NORETURN FORCE_INLINE fastpath_restore(word_t badge, word_t m
 {
     c_exit_hook();
 
-    NODE_UNLOCK;
+    /* FPU state may only be saved with the lock held */
     lazyFPURestore(cur_thread);
+    NODE_UNLOCK_FASTPATH;
 
 #ifdef CONFIG_HARDWARE_DEBUG_API
     restore_user_debug_context(cur_thread);
@@ -34,4 +34,11 @@ static inline void invalidateTLB(word_t mask)
     SMP_COND_STATEMENT(doRemoteInvalidateTLB(mask));
 }
 
+static inline void invalidateASID(vspace_root_t *vspace, asid_t asid, word_t mask)
+{
+    /* no asid support in 32-bit, just invalidate TLB */
+    invalidateLocalTLB();
+    SMP_COND_STATEMENT(batchTranslationAllASID(asid, mask));
+}
+
 #endif /* __MODE_KERNEL_TLB_H */
@@ -42,7 +42,7 @@ static inline void invalidatePCID(word_t type, void *vaddr, asid_t asid, word_t
 static inline void invalidateASID(vspace_root_t *vspace, asid_t asid, word_t mask)
 {
     invalidateLocalASID(vspace, asid);
-    SMP_COND_STATEMENT(doRemoteInvalidateASID(vspace, asid, mask));
+    SMP_COND_STATEMENT(batchTranslationAllASID(asid, mask));
 }
 
 #endif /* __MODE_KERNEL_TLB_H */
@@ -189,6 +189,11 @@ static inline void invalidateLocalTranslationSingleASID(vptr_t vptr, asid_t asid
     invalidateLocalPCID(INVPCID_TYPE_ADDR, (void *)vptr, asid);
 }
 
+static inline void invalidateLocalTranslationASID(asid_t asid)
+{
+    invalidateLocalPCID(INVPCID_TYPE_SINGLE, (void *)0, asid);
+}
+
 static inline void invalidateLocalTranslationAll(void)
 {
     invalidateLocalPCID(INVPCID_TYPE_ALL_GLOBAL, (void *)0, 0);
@@ -27,4 +27,19 @@ NORETURN;
 void fastpath_reply_recv(word_t cptr, word_t r_msgInfo)
 NORETURN;
 
+#if defined(CONFIG_SEND_FASTPATH) || defined(CONFIG_SIGNAL_FASTPATH)
+void fastpath_send(word_t cptr, word_t r_msgInfo, syscall_t syscall)
+NORETURN;
+#endif
+
+#ifdef CONFIG_RECV_FASTPATH
+void fastpath_recv(word_t cptr, word_t r_msgInfo, syscall_t syscall)
+NORETURN;
+#endif
+
+#ifdef CONFIG_VM_FAULT_FASTPATH
+void fastpath_vm_fault(vm_fault_type_t type)
+NORETURN;
+#endif
+
 #endif
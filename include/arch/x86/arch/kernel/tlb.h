@@ -14,6 +14,93 @@
 #define __ARCH_KERNEL_TLB_H
 
 #include <arch/smp/ipi_inline.h>
+#include <model/statedata.h>
+
+#ifdef ENABLE_SMP_SUPPORT
+/* Add the cores in mask to the pending batch for asid. Returns the batch,
+ * or NULL if no other core needs to be told. */
+static inline x86_tlb_shootdown_t *batchAddCores(asid_t asid, word_t mask)
+{
+    x86_tlb_shootdown_t *batch = &ARCH_NODE_STATE(x86KSTLBShootdown);
+
+    mask &= ~BIT(getCurrentCPUIndex());
+    if (mask == 0) {
+        return NULL;
+    }
+
+    if (batch->count == 0) {
+        batch->asid = asid;
+    } else if (batch->asid != asid) {
+        batch->mixed = true;
+    }
+    batch->mask |= mask;
+
+    return batch;
+}
+
+/* Defer invalidating a translation on other cores until the end of the
+ * kernel entry, where the whole batch is sent as a single remote call */
+static inline void batchTranslationASID(vptr_t vptr, asid_t asid, word_t mask)
+{
+    x86_tlb_shootdown_t *batch = batchAddCores(asid, mask);
+
+    if (batch == NULL) {
+        return;
+    }
+
+    if (batch->count < CONFIG_RANGE_FLUSH_MAX_PAGES) {
+        batch->entries[batch->count].vptr = vptr;
+        batch->entries[batch->count].asid = asid;
+    }
+    batch->count++;
+}
+
+/* Defer invalidating every translation of asid on other cores. This
+ * overflows the batch, so it is sent as a whole-ASID invalidation. */
+static inline void batchTranslationAllASID(asid_t asid, word_t mask)
+{
+    x86_tlb_shootdown_t *batch = batchAddCores(asid, mask);
+
+    if (batch == NULL) {
+        return;
+    }
+
+    batch->count = MAX(batch->count, CONFIG_RANGE_FLUSH_MAX_PAGES + 1);
+}
+
+static inline void invalidateLocalTranslationBatch(x86_tlb_shootdown_t *batch)
+{
+    word_t i;
+
+    if (batch->count > CONFIG_RANGE_FLUSH_MAX_PAGES) {
+        if (batch->mixed) {
+            invalidateLocalTranslationAll();
+        } else {
+            invalidateLocalTranslationASID(batch->asid);
+        }
+        return;
+    }
+
+    for (i = 0; i < batch->count; i++) {
+        invalidateLocalTranslationSingleASID(batch->entries[i].vptr, batch->entries[i].asid);
+    }
+}
+
+/* Send the batched invalidations to the other cores. This must be done
+ * before the kernel lock is released, as the frames may be reused as soon
+ * as another core enters the kernel. */
+static inline void flushTranslationBatch(void)
+{
+    x86_tlb_shootdown_t *batch = &ARCH_NODE_STATE(x86KSTLBShootdown);
+
+    if (unlikely(batch->mask)) {
+        doRemoteInvalidateTranslationBatch(batch, batch->mask);
+        batch->mask = 0;
+        batch->count = 0;
+        batch->mixed = false;
+    }
+}
+#endif /* ENABLE_SMP_SUPPORT */
 
 static inline void invalidatePageStructureCacheASID(paddr_t root, asid_t asid, word_t mask)
 {
@@ -30,7 +117,7 @@ static inline void invalidateTranslationSingle(vptr_t vptr, word_t mask)
 static inline void invalidateTranslationSingleASID(vptr_t vptr, asid_t asid, word_t mask)
 {
     invalidateLocalTranslationSingleASID(vptr, asid);
-    SMP_COND_STATEMENT(doRemoteInvalidateTranslationSingleASID(vptr, asid, mask));
+    SMP_COND_STATEMENT(batchTranslationASID(vptr, asid, mask));
 }
 
 static inline void invalidateTranslationAll(word_t mask)
@@ -118,6 +118,8 @@ exception_t decodeIA32PageDirectoryInvocation(word_t invLabel, word_t length, ct
 /* common functions for x86 */
 exception_t decodeX86FrameInvocation(word_t invLabel, word_t length, cte_t *cte, cap_t cap, extra_caps_t excaps,
                                      word_t *buffer);
+exception_t decodeX86VSpaceMapRange(word_t length, cap_t cap, extra_caps_t excaps, word_t *buffer);
+exception_t decodeX86VSpaceUnmapRange(word_t length, cap_t cap, extra_caps_t excaps, word_t *buffer);
 
 uint32_t CONST WritableFromVMRights(vm_rights_t vm_rights);
 uint32_t CONST SuperUserFromVMRights(vm_rights_t vm_rights);
@@ -137,6 +139,8 @@ pde_t CONST makeUserPDEInvalid(void);
 void Arch_userStackTrace(tcb_t *tptr);
 #endif
 
+void Arch_flushDeferredTranslations(void);
+
 static inline bool_t checkVPAlignment(vm_page_size_t sz, word_t w)
 {
     return IS_ALIGNED(w, pageBitsForSize(sz));
@@ -32,6 +32,7 @@
 #define IA32_FMASK_MSR          0xC0000084
 #define IA32_EFER_MSR 0xC0000080
 #define IA32_PLATFORM_INFO_MSR  0xCE
+#define IA32_TSC_DEADLINE_MSR   0x6E0
 #define IA32_XSS_MSR            0xD0A
 #define IA32_FEATURE_CONTROL_MSR 0x3A
 #define IA32_KERNEL_GS_BASE_MSR 0xC0000102
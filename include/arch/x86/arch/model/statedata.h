@@ -32,6 +32,25 @@ typedef struct {
     word_t  io_map[TSS_IO_MAP_SIZE];
 } PACKED tss_io_t;
 
+#ifdef ENABLE_SMP_SUPPORT
+/* Invalidations of other cores' TLBs deferred to the end of a kernel entry.
+ * If more than CONFIG_RANGE_FLUSH_MAX_PAGES translations are batched, the
+ * entries are dropped and the whole ASID, or the whole TLB if the batch
+ * spans several ASIDs, is invalidated instead. */
+typedef struct x86_tlb_shootdown {
+    /* cores that need to invalidate the batched translations */
+    word_t mask;
+    word_t count;
+    /* ASID of the first batched translation */
+    asid_t asid;
+    bool_t mixed;
+    struct {
+        vptr_t vptr;
+        asid_t asid;
+    } entries[CONFIG_RANGE_FLUSH_MAX_PAGES];
+} x86_tlb_shootdown_t;
+#endif /* ENABLE_SMP_SUPPORT */
+
 NODE_STATE_BEGIN(archNodeState)
 /* Interrupt currently being handled, not preserved across kernel entries */
 NODE_STATE_DECLARE(interrupt_t, x86KScurInterrupt);
@@ -40,6 +59,10 @@ NODE_STATE_DECLARE(interrupt_t, x86KScurInterrupt);
 NODE_STATE_DECLARE(interrupt_t, x86KSPendingInterrupt);
 /* Bitmask of all cores should receive the reschedule IPI */
 NODE_STATE_DECLARE(word_t, ipiReschedulePending);
+#ifdef ENABLE_SMP_SUPPORT
+/* TLB invalidations to send to other cores before leaving the kernel */
+NODE_STATE_DECLARE(x86_tlb_shootdown_t, x86KSTLBShootdown);
+#endif
 
 #ifdef CONFIG_VTX
 NODE_STATE_DECLARE(vcpu_t *, x86KSCurrentVCPU);
@@ -83,6 +106,10 @@ extern uint32_t x86KSnumIODomainIDBits;
 extern uint32_t x86KSFirstValidIODomain;
 #endif
 
+#ifdef CONFIG_TICKLESS
+extern uint32_t x86KStscMhz;
+#endif
+
 #ifdef CONFIG_PRINTING
 extern uint16_t x86KSconsolePort;
 #endif
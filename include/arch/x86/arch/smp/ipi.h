@@ -25,8 +25,9 @@ typedef enum {
     IpiRemoteCall_InvalidatePageStructureCacheASID,
     IpiRemoteCall_InvalidateTranslationSingle,
     IpiRemoteCall_InvalidateTranslationSingleASID,
+    IpiRemoteCall_InvalidateTranslationBatch,
     IpiRemoteCall_InvalidateTranslationAll,
-    IpiRemoteCall_switchFpuOwner,
+    IpiRemoteCall_ReleaseFpuState,
     IpiNumArchRemoteCall
 } IpiRemoteCall_t;
 
@@ -15,6 +15,7 @@
 
 #include <config.h>
 #include <smp/ipi.h>
+#include <arch/model/statedata.h>
 
 #ifdef ENABLE_SMP_SUPPORT
 static inline void doRemoteStall(word_t cpu)
@@ -22,9 +23,9 @@ static inline void doRemoteStall(word_t cpu)
     doRemoteOp0Arg(IpiRemoteCall_Stall, cpu);
 }
 
-static inline void doRemoteswitchFpuOwner(user_fpu_state_t *new_owner, word_t cpu)
+static inline void doRemoteReleaseFpuState(user_fpu_state_t *state, word_t cpu)
 {
-    doRemoteOp1Arg(IpiRemoteCall_switchFpuOwner, (word_t)new_owner, cpu);
+    doRemoteOp1Arg(IpiRemoteCall_ReleaseFpuState, (word_t)state, cpu);
 }
 
 static inline void doRemoteInvalidatePageStructureCacheASID(paddr_t root, asid_t asid, word_t mask)
@@ -42,6 +43,11 @@ static inline void doRemoteInvalidateTranslationSingleASID(vptr_t vptr, asid_t a
     doRemoteMaskOp2Arg(IpiRemoteCall_InvalidateTranslationSingleASID, vptr, asid, mask);
 }
 
+static inline void doRemoteInvalidateTranslationBatch(x86_tlb_shootdown_t *batch, word_t mask)
+{
+    doRemoteMaskOp1Arg(IpiRemoteCall_InvalidateTranslationBatch, (word_t)batch, mask);
+}
+
 static inline void doRemoteInvalidateTranslationAll(word_t mask)
 {
     doRemoteMaskOp0Arg(IpiRemoteCall_InvalidateTranslationAll, mask);
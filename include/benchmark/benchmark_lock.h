@@ -0,0 +1,47 @@
+/*
+ * Copyright 2019, Data61
+ * Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+ * ABN 41 687 119 230.
+ *
+ * This software may be distributed and modified according to the terms of
+ * the GNU General Public License version 2. Note that NO WARRANTY is provided.
+ * See "LICENSE_GPLv2.txt" for details.
+ *
+ * @TAG(DATA61_GPL)
+ */
+
+#ifndef BENCHMARK_LOCK_H
+#define BENCHMARK_LOCK_H
+
+#include <config.h>
+#include <types.h>
+
+#ifdef CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION
+#include <sel4/benchmark_track_types.h>
+#include <sel4/arch/constants.h>
+
+/* Maximum number of lock acquisitions that can be logged, limited by the
+ * log buffer size */
+#define MAX_LOCK_LOG_SIZE (seL4_LogBufferSize / \
+             sizeof(benchmark_track_lock_entry_t))
+
+/* Record that 'cpu' has started waiting for the kernel lock */
+void benchmark_lock_wait(word_t cpu);
+
+/* Record that 'cpu' has acquired the kernel lock */
+void benchmark_lock_acquired(word_t cpu);
+
+/* Log how long 'cpu' waited for and held the kernel lock, along with the
+ * kernel entry it was held for. Called before the lock is released. */
+void benchmark_lock_release(word_t cpu);
+#endif /* CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION */
+
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+/* Record that 'cpu' has started waiting for the kernel lock */
+void benchmark_utilisation_lock_wait(word_t cpu);
+
+/* Account the time 'cpu' waited for the kernel lock */
+void benchmark_utilisation_lock_acquired(word_t cpu);
+#endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
+
+#endif /* BENCHMARK_LOCK_H */
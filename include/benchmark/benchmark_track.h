@@ -20,9 +20,9 @@
 #include <model/statedata.h>
 #include <mode/machine.h>
 
-#if defined(CONFIG_DEBUG_BUILD) || defined(CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES)
+#if defined(CONFIG_DEBUG_BUILD) || defined(CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES) || \
+    defined(CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION)
 #define TRACK_KERNEL_ENTRIES 1
-extern kernel_entry_t ksKernelEntry;
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
 /**
  *  Calculate the maximum number of kernel entries that can be tracked,
@@ -56,10 +56,10 @@ static inline void benchmark_debug_syscall_start(word_t cptr, word_t msgInfo, wo
 {
     seL4_MessageInfo_t info = messageInfoFromWord_raw(msgInfo);
     lookupCapAndSlot_ret_t lu_ret = lookupCapAndSlot(NODE_STATE(ksCurThread), cptr);
-    ksKernelEntry.path = Entry_Syscall;
-    ksKernelEntry.syscall_no = -syscall;
-    ksKernelEntry.cap_type = cap_get_capType(lu_ret.cap);
-    ksKernelEntry.invocation_tag = seL4_MessageInfo_get_label(info);
+    NODE_STATE(ksKernelEntry).path = Entry_Syscall;
+    NODE_STATE(ksKernelEntry).syscall_no = -syscall;
+    NODE_STATE(ksKernelEntry).cap_type = cap_get_capType(lu_ret.cap);
+    NODE_STATE(ksKernelEntry).invocation_tag = seL4_MessageInfo_get_label(info);
 }
 #endif
 
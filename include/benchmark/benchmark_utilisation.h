@@ -16,6 +16,7 @@
 #include <sel4/benchmark_utilisation_types.h>
 #include <sel4/arch/constants.h>
 #include <model/statedata.h>
+#include <api/failures.h>
 
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
 extern bool_t benchmark_log_utilisation_enabled;
@@ -26,6 +27,50 @@ extern timestamp_t benchmark_end_time;
 void benchmark_track_utilisation_dump(void);
 
 void benchmark_track_reset_utilisation(void);
+
+exception_t benchmark_track_core_utilisation_dump(void);
+
+void benchmark_track_reset_core_utilisation(void);
+
+/* Charge the time since the start of the current period to 'counter' of the
+ * current core, and start a new period */
+static inline void benchmark_core_utilisation_account(word_t counter)
+{
+    benchmark_core_util_t *util = &NODE_STATE(ksCoreUtilisation);
+    timestamp_t now = timestamp();
+
+    if (likely(benchmark_log_utilisation_enabled)) {
+        util->time[counter] += now - util->period_start;
+    }
+    util->period_start = now;
+}
+
+/* Time between leaving and entering the kernel was spent in user level,
+ * less any time waiting for the kernel lock on the way in */
+static inline void benchmark_core_utilisation_entry(void)
+{
+    benchmark_core_utilisation_account(NODE_STATE(ksCoreUtilisation).idle ?
+                                       BENCHMARK_CORE_IDLE : BENCHMARK_CORE_USER);
+}
+
+static inline void benchmark_core_utilisation_exit(void)
+{
+    benchmark_core_utilisation_account(BENCHMARK_CORE_KERNEL);
+    NODE_STATE(ksCoreUtilisation).idle = NODE_STATE(ksCurThread) == NODE_STATE(ksIdleThread);
+}
+
+/* Time spent handling an interrupt is charged separately from the rest of
+ * the kernel entry it occurred in */
+static inline void benchmark_core_utilisation_irq_start(void)
+{
+    benchmark_core_utilisation_account(BENCHMARK_CORE_KERNEL);
+}
+
+static inline void benchmark_core_utilisation_irq_end(void)
+{
+    benchmark_core_utilisation_account(BENCHMARK_CORE_IRQ);
+}
+
 /* Calculate and add the utilisation time from when the heir started to run i.e. scheduled
  * and until it's being kicked off
  */
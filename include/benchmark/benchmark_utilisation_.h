@@ -15,12 +15,23 @@
 
 #include <config.h>
 #include <basic_types.h>
+#include <sel4/benchmark_utilisation_types.h>
 
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
 typedef struct {
     timestamp_t schedule_start_time;
     uint64_t    utilisation;
 } benchmark_util_t;
+
+/* Per core breakdown of where time is spent */
+typedef struct {
+    /* Start of the period not yet accounted for */
+    timestamp_t period_start;
+    timestamp_t lock_wait_start;
+    /* Whether the core last left the kernel to the idle thread */
+    bool_t      idle;
+    uint64_t    time[BENCHMARK_CORE_NUM_COUNTERS];
+} benchmark_core_util_t;
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 
 #endif /* _BENCHMARK_UTILISATION_H */
@@ -25,6 +25,31 @@ static inline void resetTimer(void)
     SYSTEM_WRITE_WORD(CNT_CTL, BIT(0));
 }
 
+#ifdef CONFIG_TICKLESS
+static inline uint64_t getTimerCount(void)
+{
+    uint64_t count;
+    SYSTEM_READ_64(CNT_CT, count);
+    return count;
+}
+
+static inline uint64_t getTimerTickLength(void)
+{
+    return TIMER_RELOAD;
+}
+
+static inline void setTimerDeadline(uint64_t deadline)
+{
+    SYSTEM_WRITE_64(CNT_CVAL, deadline);
+    SYSTEM_WRITE_WORD(CNT_CTL, BIT(0));
+}
+
+static inline void stopTimer(void)
+{
+    SYSTEM_WRITE_WORD(CNT_CTL, 0);
+}
+#endif /* CONFIG_TICKLESS */
+
 BOOT_CODE void initGenericTimer(void);
 
 #endif /* __DRIVERS_TIMER_ARM_GENERIC_H_ */
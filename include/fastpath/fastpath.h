@@ -93,6 +93,155 @@ static inline void endpoint_ptr_set_epQueue_head_np(endpoint_t *ep_ptr, word_t e
     ep_ptr->words[1] = epQueue_head;
 }
 
+/* Whether a thread woken by the fastpath lives on a different core to the
+ * current thread. Without cross-core support such IPC takes the slowpath. */
+static inline bool_t FORCE_INLINE fastpath_is_remote(tcb_t *dest)
+{
+#ifdef CONFIG_FASTPATH_CROSS_CORE
+    return dest->tcbAffinity != getCurrentCPUIndex();
+#else
+    return false;
+#endif
+}
+
+#ifdef CONFIG_FASTPATH_CROSS_CORE
+/* Make a thread woken by the fastpath runnable on its home core. The message
+ * is left in its saved context as it will not be restored by this core. The
+ * home core is only sent a reschedule IPI if the thread should preempt
+ * whatever it is running, see remoteQueueUpdate. */
+static inline void FORCE_INLINE fastpath_enqueue_remote(tcb_t *dest, word_t badge, word_t msgInfo)
+{
+    setRegister(dest, badgeRegister, badge);
+    setRegister(dest, msgInfoRegister, msgInfo);
+    SCHED_ENQUEUE(dest);
+}
+
+/* Send any reschedule IPIs generated by fastpath_enqueue_remote. */
+static inline void FORCE_INLINE fastpath_flush_reschedule(void)
+{
+    doMaskReschedule(ARCH_NODE_STATE(ipiReschedulePending));
+    ARCH_NODE_STATE(ipiReschedulePending) = 0;
+}
+
+/* The current thread blocked after waking a thread on another core, so this
+ * core needs to pick something else to run. schedule() also sends the
+ * reschedule IPI to the woken thread's core. */
+static inline void NORETURN FORCE_INLINE fastpath_schedule_local(void)
+{
+    rescheduleRequired();
+    schedule();
+    activateThread();
+    restore_user_context();
+    UNREACHABLE();
+}
+#endif /* CONFIG_FASTPATH_CROSS_CORE */
+
 #include <arch/fastpath/fastpath.h>
 
+/* As fastpath_mi_check, but also accepts messages longer than the
+ * message registers if the fastpath is configured to copy them. */
+static inline int FORCE_INLINE fastpath_mi_check_length(word_t msgInfo)
+{
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    seL4_MessageInfo_t info = messageInfoFromWord_raw(msgInfo);
+
+    return seL4_MessageInfo_get_extraCaps(info) != 0 ||
+           seL4_MessageInfo_get_length(info) > seL4_MsgMaxLength;
+#else
+    return fastpath_mi_check(msgInfo);
+#endif
+}
+
+/* As fastpath_mi_check_length, but also accepts a single extra cap if the
+ * fastpath is configured to transfer it. */
+static inline int FORCE_INLINE fastpath_mi_check_caps(word_t msgInfo)
+{
+#ifdef CONFIG_FASTPATH_CAP_TRANSFER
+    seL4_MessageInfo_t info = messageInfoFromWord_raw(msgInfo);
+
+    if (unlikely(seL4_MessageInfo_get_extraCaps(info) > 1)) {
+        return 1;
+    }
+    return fastpath_mi_check_length(wordFromMessageInfo(seL4_MessageInfo_set_extraCaps(info, 0)));
+#else
+    return fastpath_mi_check_length(msgInfo);
+#endif
+}
+
+#ifdef CONFIG_TICKLESS
+/* Whether a whole tick has passed since the last one was accounted. The
+ * fastpaths leave such entries to the slowpath, which charges the ticks
+ * to the calling thread before handling the syscall. */
+static inline bool_t FORCE_INLINE fastpath_ticks_pending(void)
+{
+    return getTimerCount() - NODE_STATE(ksLastTick) >= getTimerTickLength();
+}
+#endif /* CONFIG_TICKLESS */
+
+/* Called after switching threads on a fastpath. The timer is otherwise only
+ * reprogrammed by schedule(), and would stay armed for the end of the
+ * previous thread's time slice or budget. */
+static inline void FORCE_INLINE fastpath_set_timer_deadline(void)
+{
+#ifdef CONFIG_TICKLESS
+    setNextTimerDeadline();
+#endif /* CONFIG_TICKLESS */
+}
+
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+typedef struct fastpath_buffers {
+    word_t *sendBuffer;
+    word_t *receiveBuffer;
+} fastpath_buffers_t;
+
+/* Look up the IPC buffers needed to copy a message of the given length.
+ * The slowpath truncates long messages if either buffer is missing, so
+ * this fails in that case. */
+static inline bool_t FORCE_INLINE fastpath_lookup_buffers(word_t length, tcb_t *sender,
+                                                          tcb_t *receiver, fastpath_buffers_t *bufs)
+{
+    if (likely(length <= n_msgRegisters)) {
+        bufs->sendBuffer = NULL;
+        bufs->receiveBuffer = NULL;
+        return true;
+    }
+
+    bufs->sendBuffer = lookupIPCBuffer(false, sender);
+    bufs->receiveBuffer = lookupIPCBuffer(true, receiver);
+
+    return bufs->sendBuffer != NULL && bufs->receiveBuffer != NULL;
+}
+
+/* Copy a message that may extend beyond the message registers. Words
+ * past the registers are copied between the IPC buffers four at a time,
+ * which the compiler is free to vectorise. */
+static inline void FORCE_INLINE fastpath_copy_long_mrs(word_t length, tcb_t *src, tcb_t *dest,
+                                                       fastpath_buffers_t *bufs)
+{
+    word_t i;
+    word_t *sendBuf, *recvBuf;
+
+    if (likely(length <= n_msgRegisters)) {
+        fastpath_copy_mrs(length, src, dest);
+        return;
+    }
+
+    fastpath_copy_mrs(n_msgRegisters, src, dest);
+
+    /* Message register i is at offset i + 1 in the IPC buffer */
+    sendBuf = bufs->sendBuffer + 1;
+    recvBuf = bufs->receiveBuffer + 1;
+
+    for (i = n_msgRegisters; i + 4 <= length; i += 4) {
+        recvBuf[i] = sendBuf[i];
+        recvBuf[i + 1] = sendBuf[i + 1];
+        recvBuf[i + 2] = sendBuf[i + 2];
+        recvBuf[i + 3] = sendBuf[i + 3];
+    }
+    for (; i < length; i++) {
+        recvBuf[i] = sendBuf[i];
+    }
+}
+#endif /* CONFIG_FASTPATH_LONG_MESSAGES */
+
 #endif
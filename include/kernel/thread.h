@@ -36,6 +36,70 @@ static inline CONST word_t l1index_to_prio(word_t l1index)
     return (l1index << wordRadix);
 }
 
+/* Longest time slice a thread may be given, in timer ticks. A deadline
+ * this many ticks past the current timer count cannot overflow it. */
+#define MAX_TIME_SLICE_TICKS BIT(24)
+
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+/* Longest domain schedule entry, in timer ticks. Like a time slice, it
+ * must not overflow the timer deadline it is programmed into. */
+#define MAX_DOMAIN_LENGTH_TICKS BIT(24)
+#endif
+
+/* Number of ticks a thread's timeslice is refilled to */
+static inline word_t PURE threadTimeSlice(const tcb_t *thread)
+{
+#ifdef CONFIG_THREAD_TIME_SLICE
+    return thread->tcbTimeSliceLength;
+#else
+    return CONFIG_TIME_SLICE;
+#endif
+}
+
+#ifdef CONFIG_THREAD_BUDGETS
+/* Longest budget period, in timer ticks. Period ends and the deadlines
+ * derived from them cannot overflow. */
+#define MAX_BUDGET_PERIOD_TICKS BIT(24)
+
+/* A thread out of budget waits in the release queue of its core and must
+ * not be added to a ready queue until it is replenished */
+static inline bool_t PURE isThrottled(const tcb_t *thread)
+{
+    return thread->tcbPeriod != 0 && thread->tcbBudgetRemaining == 0;
+}
+#endif /* CONFIG_THREAD_BUDGETS */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+/* Priority a server runs at while it serves the caller */
+static inline prio_t PURE inheritedPriority(const tcb_t *server, const tcb_t *caller)
+{
+    return MIN(caller->tcbPriority, server->tcbInheritMCP);
+}
+
+/* Whether receiving a call from the caller raises the priority of the server */
+static inline bool_t PURE inheritsPriorityFrom(const tcb_t *server, const tcb_t *caller)
+{
+    return server->tcbInheritPriority && inheritedPriority(server, caller) > server->tcbPriority;
+}
+
+/* Whether the thread runs at a priority inherited from a caller */
+static inline bool_t PURE hasInheritedPriority(const tcb_t *thread)
+{
+    return thread->tcbInheritedFrom != NULL;
+}
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+
+/* Priority of the thread without any inherited from a caller */
+static inline prio_t PURE threadBasePriority(const tcb_t *thread)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    if (hasInheritedPriority(thread)) {
+        return thread->tcbBasePriority;
+    }
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+    return thread->tcbPriority;
+}
+
 static inline bool_t PURE isRunnable(const tcb_t *thread)
 {
     switch (thread_state_get_tsType(thread->tcbState)) {
@@ -104,7 +168,21 @@ void scheduleTCB(tcb_t *tptr);
 void possibleSwitchTo(tcb_t *tptr);
 void setThreadState(tcb_t *tptr, _thread_state_t ts);
 void timerTick(void);
+#ifdef CONFIG_TICKLESS
+void timerTicksElapsed(void);
+void setNextTimerDeadline(void);
+void handleTimerDeadline(void);
+#endif /* CONFIG_TICKLESS */
 void rescheduleRequired(void);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+void inheritPriority(tcb_t *server, tcb_t *caller);
+void restorePriority(tcb_t *tptr);
+void endInheritance(tcb_t *caller);
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+#ifdef CONFIG_THREAD_BUDGETS
+void releaseEnqueue(tcb_t *tcb);
+void releaseDequeue(tcb_t *tcb);
+#endif /* CONFIG_THREAD_BUDGETS */
 
 /* declare that the thread has had its registers (in its user_context_t) modified and it
  * should ignore any 'efficient' restores next time it is run, and instead restore all
@@ -15,6 +15,7 @@
 #include <util.h>
 #include <arch/kernel/traps.h>
 #include <smp/lock.h>
+#include <benchmark/benchmark_utilisation.h>
 
 /* This C function should be the first thing called from C after entry from
  * assembly. It provides a single place to do any entry work that is not
@@ -25,6 +26,9 @@ static inline void c_entry_hook(void)
 #if defined(CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES) || defined(CONFIG_BENCHMARK_TRACK_UTILISATION)
     ksEnter = timestamp();
 #endif
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_core_utilisation_entry();
+#endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 }
 
 /* This C function should be the last thing called from C before exiting
@@ -36,6 +40,9 @@ static inline void c_exit_hook(void)
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
     benchmark_track_exit();
 #endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES */
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_core_utilisation_exit();
+#endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
     arch_c_exit_hook();
 }
 
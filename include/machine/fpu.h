@@ -23,14 +23,27 @@
 /* Perform any actions required for the deletion of the given thread. */
 void fpuThreadDelete(tcb_t *thread);
 
+#ifdef ENABLE_SMP_SUPPORT
+/* Perform any actions required before the given thread changes core. */
+void fpuThreadMigrate(tcb_t *thread);
+
+/* Release FPU state that another core asked this core to give up. */
+void handleFpuReleaseRequest(void);
+
+/* Save and release the given FPU state if it is live on this core, for a
+ * core that holds the kernel lock and waits for it to be done. */
+void handleRemoteFpuRelease(user_fpu_state_t *state);
+#endif /* ENABLE_SMP_SUPPORT */
+
+/* Switch out FPU state that appears to be no longer in use. Returns false if
+ * this cannot be done yet. */
+bool_t releaseUnusedFpuState(void);
+
 /* Handle an FPU exception. */
 exception_t handleFPUFault(void);
 
 void switchLocalFpuOwner(user_fpu_state_t *new_owner);
 
-/* Switch the current owner of the FPU state on the core specified by 'cpu'. */
-void switchFpuOwner(user_fpu_state_t *new_owner, word_t cpu);
-
 /* Returns whether or not the passed thread is using the current active fpu state */
 static inline bool_t nativeThreadUsingFPU(tcb_t *thread)
 {
@@ -40,12 +53,17 @@ static inline bool_t nativeThreadUsingFPU(tcb_t *thread)
 
 static inline void FORCE_INLINE lazyFPURestore(tcb_t *thread)
 {
+#ifdef ENABLE_SMP_SUPPORT
+    if (unlikely(NODE_STATE(ksFPUReleaseState))) {
+        handleFpuReleaseRequest();
+    }
+#endif /* ENABLE_SMP_SUPPORT */
     if (unlikely(NODE_STATE(ksActiveFPUState))) {
         /* If we have enabled/disabled the FPU too many times without
          * someone else trying to use it, we assume it is no longer
          * in use and switch out its state. */
-        if (unlikely(NODE_STATE(ksFPURestoresSinceSwitch) > CONFIG_FPU_MAX_RESTORES_SINCE_SWITCH)) {
-            switchLocalFpuOwner(NULL);
+        if (unlikely(NODE_STATE(ksFPURestoresSinceSwitch) > CONFIG_FPU_MAX_RESTORES_SINCE_SWITCH)
+            && releaseUnusedFpuState()) {
             NODE_STATE(ksFPURestoresSinceSwitch) = 0;
         } else {
             if (likely(nativeThreadUsingFPU(thread))) {
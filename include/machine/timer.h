@@ -14,4 +14,18 @@
 
 static inline void resetTimer(void);
 
+#ifdef CONFIG_TICKLESS
+/* Read the counter that timer deadlines are compared against */
+static inline uint64_t getTimerCount(void);
+
+/* Length of a timer tick in counter units */
+static inline uint64_t getTimerTickLength(void);
+
+/* Interrupt once the counter reaches 'deadline', which may be in the past */
+static inline void setTimerDeadline(uint64_t deadline);
+
+/* Cancel any programmed deadline */
+static inline void stopTimer(void);
+#endif /* CONFIG_TICKLESS */
+
 #endif
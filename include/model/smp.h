@@ -30,6 +30,10 @@ extern smpStatedata_t ksSMP[CONFIG_MAX_NUM_NODES];
 
 void migrateTCB(tcb_t *tcb, word_t new_core);
 
+#ifdef CONFIG_WORK_STEALING
+tcb_t *stealThread(word_t dom);
+#endif /* CONFIG_WORK_STEALING */
+
 #endif /* ENABLE_SMP_SUPPORT */
 
 #endif /* __MODEL_SMP_H_ */
@@ -18,6 +18,7 @@
 #include <object/structures.h>
 #include <object/tcb.h>
 #include <mode/types.h>
+#include <sel4/benchmark_track_types.h>
 
 #ifdef ENABLE_SMP_SUPPORT
 #define NODE_STATE_BEGIN(_name)                 typedef struct _name {
@@ -75,10 +76,44 @@ NODE_STATE_DECLARE(tcb_t, *ksSchedulerAction);
 NODE_STATE_DECLARE(user_fpu_state_t *, ksActiveFPUState);
 /* Number of times we have restored a user context with an active FPU without switching it */
 NODE_STATE_DECLARE(word_t, ksFPURestoresSinceSwitch);
+#ifdef ENABLE_SMP_SUPPORT
+/* FPU state another core has asked this core to release, and whether to save it first */
+NODE_STATE_DECLARE(user_fpu_state_t *, ksFPUReleaseState);
+NODE_STATE_DECLARE(bool_t, ksFPUReleaseSave);
+#endif /* ENABLE_SMP_SUPPORT */
 #endif /* CONFIG_HAVE_FPU */
 #ifdef CONFIG_DEBUG_BUILD
 NODE_STATE_DECLARE(tcb_t *, ksDebugTCBs);
 #endif /* CONFIG_DEBUG_BUILD */
+#ifdef CONFIG_WORK_STEALING
+/* Timer ticks spent idle since the last attempt to steal a thread */
+NODE_STATE_DECLARE(word_t, ksWorkStealTicks);
+/* Ready queues that may hold a migratable thread, one bit per priority.
+ * Set when a migratable thread is queued, cleared by a steal attempt that
+ * finds none in the queue. */
+NODE_STATE_DECLARE(word_t, ksMigratableBitmap[CONFIG_NUM_DOMAINS][L2_BITMAP_SIZE]);
+#endif /* CONFIG_WORK_STEALING */
+#ifdef CONFIG_THREAD_BUDGETS
+/* Timer ticks accounted since boot */
+NODE_STATE_DECLARE(uint64_t, ksTicks);
+/* Threads out of budget, ordered by the end of their period */
+NODE_STATE_DECLARE(tcb_queue_t, ksReleaseQueue);
+#endif /* CONFIG_THREAD_BUDGETS */
+#ifdef CONFIG_TICKLESS
+/* Timer count of the last tick that has been accounted */
+NODE_STATE_DECLARE(uint64_t, ksLastTick);
+/* Deadline the timer is currently programmed with, or 0 if stopped */
+NODE_STATE_DECLARE(uint64_t, ksTimerDeadline);
+#endif /* CONFIG_TICKLESS */
+#if (defined CONFIG_DEBUG_BUILD || defined CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES \
+     || defined CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION)
+/* Details of the current kernel entry. Kept per core, as fastpaths taking
+ * only an object lock may run on several cores at once */
+NODE_STATE_DECLARE(kernel_entry_t, ksKernelEntry);
+#endif /* DEBUG */
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+NODE_STATE_DECLARE(benchmark_core_util_t, ksCoreUtilisation);
+#endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 
 NODE_STATE_END(nodeState);
 
@@ -96,6 +131,13 @@ extern cte_t intStateIRQNode[];
 extern const dschedule_t ksDomSchedule[];
 extern const word_t ksDomScheduleLength;
 extern word_t ksDomScheduleIdx;
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+extern dschedule_t ksDomScheduleBuffers[2][CONFIG_MAX_DOMAIN_SCHEDULE_LENGTH];
+extern const dschedule_t *ksCurDomSchedule;
+extern word_t ksCurDomScheduleLength;
+extern dschedule_t *ksStagedDomSchedule;
+extern word_t ksPendingDomScheduleLength;
+#endif /* CONFIG_RUNTIME_DOMAIN_SCHEDULE */
 extern dom_t ksCurDomain;
 extern word_t ksDomainTime;
 extern word_t tlbLockCount VISIBLE;
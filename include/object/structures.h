@@ -241,9 +241,48 @@ struct tcb {
     /* Priority, 1 byte (padded to 1 word) */
     prio_t tcbPriority;
 
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    /* Priority set for the thread, which tcbPriority is restored to after
+     * a call it inherited a higher priority from, 1 byte (padded to 1 word) */
+    prio_t tcbBasePriority;
+
+    /* whether the thread inherits the priority of its callers, 1 word */
+    word_t tcbInheritPriority;
+
+    /* Highest priority the thread may inherit, the MCP of the authority
+     * that enabled inheritance, 1 byte (padded to 1 word) */
+    prio_t tcbInheritMCP;
+
+    /* Caller the thread currently runs at the priority of, or NULL, 1 word */
+    struct tcb *tcbInheritedFrom;
+
+    /* Server currently running at the priority of the thread, or NULL,
+     * 1 word */
+    struct tcb *tcbInheritedBy;
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+
     /* Timeslice remaining, 1 word */
     word_t tcbTimeSlice;
 
+#ifdef CONFIG_THREAD_TIME_SLICE
+    /* Ticks the timeslice is refilled to, 1 word */
+    word_t tcbTimeSliceLength;
+#endif /* CONFIG_THREAD_TIME_SLICE */
+
+#ifdef CONFIG_THREAD_BUDGETS
+    /* Ticks the thread may run for in each period, 1 word */
+    word_t tcbBudget;
+
+    /* Length of a budget period in ticks, 0 if unlimited, 1 word */
+    word_t tcbPeriod;
+
+    /* Budget remaining in the current period, 1 word */
+    word_t tcbBudgetRemaining;
+
+    /* Tick at which the current period ends, 8 bytes */
+    uint64_t tcbPeriodEnd;
+#endif /* CONFIG_THREAD_BUDGETS */
+
     /* Capability pointer to thread fault handler, 1 word */
     cptr_t tcbFaultHandler;
 
@@ -255,6 +294,11 @@ struct tcb {
     word_t tcbAffinity;
 #endif /* ENABLE_SMP_SUPPORT */
 
+#ifdef CONFIG_WORK_STEALING
+    /* whether other cores may take this thread from its ready queue, 1 word */
+    word_t tcbMigratable;
+#endif /* CONFIG_WORK_STEALING */
+
     /* Previous and next pointers for scheduler queues , 2 words */
     struct tcb *tcbSchedNext;
     struct tcb *tcbSchedPrev;
@@ -13,9 +13,37 @@
 #ifndef __PLAT_MACHINE_TIMER_H
 #define __PLAT_MACHINE_TIMER_H
 
+#include <config.h>
+#include <arch/machine.h>
+#include <arch/model/statedata.h>
+
 static inline void resetTimer(void)
 {
     /* nothing to do */
 }
 
+#ifdef CONFIG_TICKLESS
+/* The local APIC timer is used in TSC-deadline mode */
+static inline uint64_t getTimerCount(void)
+{
+    return x86_rdtsc();
+}
+
+static inline uint64_t getTimerTickLength(void)
+{
+    return (uint64_t)x86KStscMhz * US_IN_MS * CONFIG_TIMER_TICK_MS;
+}
+
+static inline void setTimerDeadline(uint64_t deadline)
+{
+    /* a deadline of 0 would disarm the timer */
+    x86_wrmsr(IA32_TSC_DEADLINE_MSR, deadline ? deadline : 1);
+}
+
+static inline void stopTimer(void)
+{
+    x86_wrmsr(IA32_TSC_DEADLINE_MSR, 0);
+}
+#endif /* CONFIG_TICKLESS */
+
 #endif /* !__PLAT_MACHINE_TIMER_H */
@@ -21,36 +21,33 @@
 #ifdef ENABLE_SMP_SUPPORT
 #define MAX_IPI_ARGS    3   /* Maximum number of parameters to remote function */
 
-static volatile struct {
-    word_t count;
-    word_t globalsense;
-
-    PAD_TO_NEXT_CACHE_LN(sizeof(word_t) + sizeof(word_t));
-} ipiSyncBarrier = {0};                  /* IPI barrier for remote call synchronization */
-
-static volatile word_t totalCoreBarrier; /* number of cores involved in IPI 'in progress' */
-static word_t ipi_args[MAX_IPI_ARGS];    /* data to be passed to the remote call function */
-
-static inline word_t get_ipi_arg(word_t n)
-{
-    assert(n < MAX_IPI_ARGS);
-    return ipi_args[n];
-}
-
-static inline void ipi_wait(word_t cores)
-{
-    word_t localsense = ipiSyncBarrier.globalsense;
-
-    if (__atomic_fetch_add(&ipiSyncBarrier.count, 1, __ATOMIC_ACQ_REL) == cores) {
-        ipiSyncBarrier.count = 0;
-        ipiSyncBarrier.globalsense =
-            ~ipiSyncBarrier.globalsense;
-    }
-
-    while (localsense == ipiSyncBarrier.globalsense) {
-        arch_pause();
-    }
-}
+/* A remote call posted to one or more cores. 'pending' counts the target
+ * cores that have not yet run the call; the initiator may only reuse the
+ * descriptor once it drops to zero. */
+typedef struct remote_call {
+    word_t call;
+    word_t args[MAX_IPI_ARGS];
+    word_t pending;
+} remote_call_t;
+
+/* Links a remote call into the queue of a single target core */
+typedef struct remote_call_node {
+    struct remote_call_node *next;
+    remote_call_t *call;
+} remote_call_node_t;
+
+/* Per-core multiple-producer, single-consumer queue of remote calls. Other
+ * cores push onto 'head' with a compare-and-swap. The owning core takes the
+ * whole list at once and moves it, oldest first, onto 'local', from which it
+ * runs the calls one at a time. */
+typedef struct remote_call_queue {
+    remote_call_node_t *head;
+    remote_call_node_t *local;
+    /* the call being run, completed once the handler has finished with it */
+    remote_call_t *current;
+
+    PAD_TO_NEXT_CACHE_LN(3 * sizeof(void *));
+} remote_call_queue_t;
 
 /* Architecture independent function for sending handling pre-hardware-send IPIs */
 void generic_ipi_send_mask(irq_t ipi, word_t mask, bool_t isBlocking);
@@ -83,6 +80,7 @@ void handleIPI(irq_t irq, bool_t irqPath);
 /*
  * Run a synchronous function on all cores specified by mask. Return when target cores
  * have all executed the function. Caller must hold the lock.
+ * Only waits for the target cores, other cores are not involved.
  *
  * @param func the function to run
  * @param data1 passed to the function as first parameter
@@ -91,6 +89,18 @@ void handleIPI(irq_t irq, bool_t irqPath);
  */
 void doRemoteMaskOp(IpiRemoteCall_t func, word_t data1, word_t data2, word_t data3, word_t mask);
 
+/*
+ * Run an asynchronous function on all cores specified by mask. Returns once the call
+ * is queued on the target cores, which run it the next time they take a remote call
+ * IPI or acquire the lock, in the order calls were posted to them.
+ *
+ * @param func the function to run
+ * @param data1 passed to the function as first parameter
+ * @param data2 passed to the function as second parameter
+ * @param mask cores to run function on
+ */
+void doRemoteMaskOpAsync(IpiRemoteCall_t func, word_t data1, word_t data2, word_t data3, word_t mask);
+
 /* Run a synchronous function on a core specified by cpu.
  *
  * @param func the function to run
@@ -103,6 +113,18 @@ static void inline doRemoteOp(IpiRemoteCall_t func, word_t data1, word_t data2,
     doRemoteMaskOp(func, data1, data2, data3, BIT(cpu));
 }
 
+/* Run an asynchronous function on a core specified by cpu.
+ *
+ * @param func the function to run
+ * @param data1 passed to the function as first parameter
+ * @param data2 passed to the function as second parameter
+ * @param cpu core to run function on
+ */
+static void inline doRemoteOpAsync(IpiRemoteCall_t func, word_t data1, word_t data2, word_t data3, word_t cpu)
+{
+    doRemoteMaskOpAsync(func, data1, data2, data3, BIT(cpu));
+}
+
 /* List of wrapper functions
  *
  * doRemote[Mask]Op0Arg: do remote operation without any argument
@@ -151,12 +173,26 @@ static void inline doRemoteOp2Arg(IpiRemoteCall_t func, word_t data1, word_t dat
 }
 
 /* This is asynchronous call and could be called outside the lock.
- * Returns immediately.
+ * Returns immediately. Cores that have not yet scheduled since the last
+ * reschedule IPI sent to them are skipped, see clearPendingReschedule.
  *
  * @param mask cores to request rescheduling
  */
 void doMaskReschedule(word_t mask);
 
+/* Called by schedule() to allow further reschedule IPIs to this core.
+ * Returns whether a reschedule had been requested. */
+bool_t clearPendingReschedule(void);
+
+/* Number of reschedule IPIs not sent because the target core had one pending */
+extern word_t ksRescheduleIPIsSuppressed;
+
+#ifdef CONFIG_X86_IDLE_MWAIT
+/* Address of the flag set by doMaskReschedule for a core, which that core's
+ * idle thread monitors in place of receiving a reschedule IPI */
+word_t *getRescheduleWakeWord(word_t core);
+#endif /* CONFIG_X86_IDLE_MWAIT */
+
 /* Request rescheduling on a core specified by cpu.
  * Returns immediately.
  *
@@ -20,9 +20,17 @@
 #include <arch/model/statedata.h>
 #include <smp/ipi.h>
 #include <util.h>
+#include <benchmark/benchmark_lock.h>
 
 #ifdef ENABLE_SMP_SUPPORT
 
+/* The big kernel lock is a queue lock whose algorithm is chosen with
+ * KernelLockAlgorithm. Every algorithm provides the same clh_ interface, so
+ * the name only reflects the default. A core polls for the lock separately
+ * from joining its queue (clh_lock_granted), so that a core stalled by a
+ * remote call while waiting can finish acquiring it from the IPI handler. */
+
+#ifdef CONFIG_LOCK_CLH
 /* CLH lock is FIFO lock for machines with coherent caches (coherent-FIFO lock).
  * See ftp://ftp.cs.washington.edu/tr/1993/02/UW-CSE-93-02-02.pdf */
 
@@ -56,22 +64,199 @@ typedef struct clh_lock {
     PAD_TO_NEXT_CACHE_LN(sizeof(clh_qnode_t *));
 } clh_lock_t;
 
-extern clh_lock_t big_kernel_lock;
+typedef clh_lock_t kernel_lock_t;
+#endif /* CONFIG_LOCK_CLH */
+
+#ifdef CONFIG_LOCK_MCS
+/* MCS lock: each waiter spins on a flag in its own queue node, which its
+ * predecessor clears on release, so a handoff only moves one cache line
+ * between the two cores involved.
+ * See https://doi.org/10.1145/103727.103729 */
+
+typedef struct mcs_qnode {
+    struct mcs_qnode *next;
+    word_t locked;
+
+    PAD_TO_NEXT_CACHE_LN(sizeof(struct mcs_qnode *) + sizeof(word_t));
+} mcs_qnode_t;
+
+typedef struct mcs_lock_node {
+    mcs_qnode_t node;
+    /* Set from joining the queue until the lock is released */
+    word_t queued;
+    /* This is the software IPI flag */
+    word_t ipi;
+
+    PAD_TO_NEXT_CACHE_LN(sizeof(word_t) + sizeof(word_t));
+} mcs_lock_node_t;
+
+typedef struct mcs_lock {
+    mcs_lock_node_t node_owners[CONFIG_MAX_NUM_NODES];
+
+    mcs_qnode_t *tail;
+    PAD_TO_NEXT_CACHE_LN(sizeof(mcs_qnode_t *));
+} mcs_lock_t;
+
+typedef mcs_lock_t kernel_lock_t;
+#endif /* CONFIG_LOCK_MCS */
+
+#if defined(CONFIG_LOCK_TICKET) || defined(CONFIG_LOCK_COHORT)
+typedef struct lock_counter {
+    word_t value;
+
+    PAD_TO_NEXT_CACHE_LN(sizeof(word_t));
+} lock_counter_t;
+#endif
+
+#ifdef CONFIG_LOCK_TICKET
+/* Ticket lock: waiters take a ticket and wait for it to be served. Waiters
+ * back off in proportion to their distance from the head of the queue, which
+ * keeps the number of cores polling the shared counter low. */
+
+typedef struct ticket_lock_node {
+    word_t ticket;
+    /* Set from taking a ticket until the lock is released */
+    word_t queued;
+    /* This is the software IPI flag */
+    word_t ipi;
+
+    PAD_TO_NEXT_CACHE_LN(3 * sizeof(word_t));
+} ticket_lock_node_t;
+
+typedef struct ticket_lock {
+    ticket_lock_node_t node_owners[CONFIG_MAX_NUM_NODES];
+
+    lock_counter_t next_ticket;
+    lock_counter_t now_serving;
+} ticket_lock_t;
+
+typedef ticket_lock_t kernel_lock_t;
+#endif /* CONFIG_LOCK_TICKET */
+
+#ifdef CONFIG_LOCK_COHORT
+/* Cohort lock built from ticket locks: cores first take the lock of their
+ * cluster, then the global lock. On release, the global lock is passed to
+ * the next waiter of the same cluster instead, up to
+ * CONFIG_LOCK_COHORT_MAX_HANDOFFS times in a row, so that the data protected
+ * by the lock stays in the caches of one socket.
+ * See https://doi.org/10.1145/2686884 */
+
+#define COHORT_NUM_CLUSTERS \
+    ((CONFIG_MAX_NUM_NODES + CONFIG_LOCK_COHORT_CLUSTER_SIZE - 1) / CONFIG_LOCK_COHORT_CLUSTER_SIZE)
+#define COHORT_CLUSTER(_cpu) ((_cpu) / CONFIG_LOCK_COHORT_CLUSTER_SIZE)
+
+typedef enum {
+    CohortState_Local = 0,
+    CohortState_Global,
+    CohortState_Held
+} cohort_state_t;
+
+typedef struct cohort_cluster {
+    lock_counter_t next_ticket;
+    lock_counter_t now_serving;
+    /* Set while the global lock is held on behalf of this cluster */
+    word_t owns_global;
+    /* Global ticket taken by this cluster */
+    word_t global_ticket;
+    /* Number of times in a row the global lock stayed in this cluster */
+    word_t handoffs;
+
+    PAD_TO_NEXT_CACHE_LN(3 * sizeof(word_t));
+} cohort_cluster_t;
+
+typedef struct cohort_lock_node {
+    word_t ticket;
+    /* a cohort_state_t */
+    word_t state;
+    /* Set from taking a ticket until the lock is released */
+    word_t queued;
+    /* This is the software IPI flag */
+    word_t ipi;
+
+    PAD_TO_NEXT_CACHE_LN(4 * sizeof(word_t));
+} cohort_lock_node_t;
+
+typedef struct cohort_lock {
+    cohort_lock_node_t node_owners[CONFIG_MAX_NUM_NODES];
+    cohort_cluster_t clusters[COHORT_NUM_CLUSTERS];
+
+    lock_counter_t next_ticket;
+    lock_counter_t now_serving;
+} cohort_lock_t;
+
+typedef cohort_lock_t kernel_lock_t;
+#endif /* CONFIG_LOCK_COHORT */
+
+extern kernel_lock_t big_kernel_lock;
 BOOT_CODE void clh_lock_init(void);
 
+#ifdef CONFIG_FASTPATH_FINE_GRAINED_LOCKING
+/* With fine-grained locking the IPC fastpaths run without the big kernel
+ * lock. A core running a fastpath sets its 'active' flag, and whoever takes
+ * the big kernel lock waits for all flags to clear before touching kernel
+ * state. Fastpaths on different cores are serialised by a lock on the
+ * endpoint or notification they operate on, taken from a hashed table. A
+ * fastpath holds at most one object lock and never waits while holding it. */
+#define FASTPATH_OBJECT_LOCK_BITS 6
+
+typedef struct fastpath_lock_node {
+    /* Set while this core runs a fastpath without the big kernel lock */
+    word_t active;
+    /* Object lock held by the fastpath on this core, if any */
+    word_t *held;
+
+    PAD_TO_NEXT_CACHE_LN(sizeof(word_t) + sizeof(word_t *));
+} fastpath_lock_node_t;
+
+typedef struct fastpath_object_lock {
+    word_t locked;
+
+    PAD_TO_NEXT_CACHE_LN(sizeof(word_t));
+} fastpath_object_lock_t;
+
+typedef struct fastpath_lock {
+    fastpath_lock_node_t nodes[CONFIG_MAX_NUM_NODES];
+    fastpath_object_lock_t objects[BIT(FASTPATH_OBJECT_LOCK_BITS)];
+    /* Set while some core holds the big kernel lock */
+    word_t exclusive;
+} fastpath_lock_t;
+
+extern fastpath_lock_t fastpath_lock;
+
+/* Called once the big kernel lock is held: keep new fastpaths out and wait
+ * for running ones to finish. */
+static inline void FORCE_INLINE fastpath_lock_drain(word_t cpu)
+{
+    __atomic_store_n(&fastpath_lock.exclusive, 1, __ATOMIC_RELAXED);
+    /* Pairs with the fence in fastpath_lock_acquire: either we see the
+     * other core's flag, or it sees 'exclusive' */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    for (word_t i = 0; i < CONFIG_MAX_NUM_NODES; i++) {
+        while (i != cpu && __atomic_load_n(&fastpath_lock.nodes[i].active, __ATOMIC_ACQUIRE)) {
+            arch_pause();
+        }
+    }
+}
+
+static inline void FORCE_INLINE fastpath_lock_undrain(void)
+{
+    __atomic_store_n(&fastpath_lock.exclusive, 0, __ATOMIC_RELEASE);
+}
+#endif /* CONFIG_FASTPATH_FINE_GRAINED_LOCKING */
+
 static inline bool_t FORCE_INLINE clh_is_ipi_pending(word_t cpu)
 {
     return big_kernel_lock.node_owners[cpu].ipi == 1;
 }
 
-static inline void *sel4_atomic_exchange(void *ptr, bool_t
-                                         irqPath, word_t cpu, int memorder)
+#if defined(CONFIG_LOCK_CLH) || defined(CONFIG_LOCK_MCS)
+static inline void *sel4_atomic_exchange(void *ptr, void *new_val, bool_t irqPath,
+                                         word_t cpu, int memorder)
 {
-    clh_qnode_t *prev;
+    void *prev;
 
-    while (!try_arch_atomic_exchange(&big_kernel_lock.head,
-                                     (void *) big_kernel_lock.node_owners[cpu].node, (void **) &prev,
-                                     memorder, __ATOMIC_ACQUIRE)) {
+    while (!try_arch_atomic_exchange(ptr, new_val, &prev, memorder, __ATOMIC_ACQUIRE)) {
         if (clh_is_ipi_pending(cpu)) {
             /* we only handle irq_remote_call_ipi here as other type of IPIs
              * are async and could be delayed. 'handleIPI' may not return
@@ -84,19 +269,218 @@ static inline void *sel4_atomic_exchange(void *ptr, bool_t
 
     return prev;
 }
+#endif
 
-static inline void FORCE_INLINE clh_lock_acquire(word_t cpu, bool_t irqPath)
+#ifdef CONFIG_LOCK_CLH
+static inline void FORCE_INLINE clh_lock_enqueue(word_t cpu, bool_t irqPath)
 {
     clh_qnode_t *prev;
+
     big_kernel_lock.node_owners[cpu].node->value = CLHState_Pending;
 
-    prev = sel4_atomic_exchange(&big_kernel_lock.head, irqPath, cpu, __ATOMIC_ACQUIRE);
+    prev = sel4_atomic_exchange(&big_kernel_lock.head, big_kernel_lock.node_owners[cpu].node,
+                                irqPath, cpu, __ATOMIC_ACQUIRE);
 
     big_kernel_lock.node_owners[cpu].next = prev;
+}
+
+static inline bool_t FORCE_INLINE clh_lock_granted(word_t cpu)
+{
+    return big_kernel_lock.node_owners[cpu].next->value == CLHState_Granted;
+}
+
+static inline void FORCE_INLINE clh_lock_handoff(word_t cpu)
+{
+    big_kernel_lock.node_owners[cpu].node->value = CLHState_Granted;
+    big_kernel_lock.node_owners[cpu].node =
+        big_kernel_lock.node_owners[cpu].next;
+}
+
+static inline bool_t FORCE_INLINE clh_is_self_in_queue(void)
+{
+    return big_kernel_lock.node_owners[getCurrentCPUIndex()].node->value == CLHState_Pending;
+}
+#endif /* CONFIG_LOCK_CLH */
+
+#ifdef CONFIG_LOCK_MCS
+static inline void FORCE_INLINE clh_lock_enqueue(word_t cpu, bool_t irqPath)
+{
+    mcs_qnode_t *node = &big_kernel_lock.node_owners[cpu].node;
+    mcs_qnode_t *prev;
+
+    big_kernel_lock.node_owners[cpu].queued = 1;
+    node->next = NULL;
+    node->locked = 1;
+
+    prev = sel4_atomic_exchange(&big_kernel_lock.tail, node, irqPath, cpu, __ATOMIC_ACQ_REL);
+
+    if (prev) {
+        /* the initialisation of our node is ordered before the link */
+        __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+    } else {
+        node->locked = 0;
+    }
+}
+
+static inline bool_t FORCE_INLINE clh_lock_granted(word_t cpu)
+{
+    return __atomic_load_n(&big_kernel_lock.node_owners[cpu].node.locked, __ATOMIC_RELAXED) == 0;
+}
+
+static inline void FORCE_INLINE clh_lock_handoff(word_t cpu)
+{
+    mcs_qnode_t *node = &big_kernel_lock.node_owners[cpu].node;
+    mcs_qnode_t *next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+
+    big_kernel_lock.node_owners[cpu].queued = 0;
+
+    if (!next) {
+        mcs_qnode_t *expected = node;
+        if (__atomic_compare_exchange_n(&big_kernel_lock.tail, &expected, NULL, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            return;
+        }
+        /* a successor has swapped the tail but not yet linked itself */
+        while (!(next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE))) {
+            arch_pause();
+        }
+    }
+
+    __atomic_store_n(&next->locked, 0, __ATOMIC_RELEASE);
+}
+
+static inline bool_t FORCE_INLINE clh_is_self_in_queue(void)
+{
+    return big_kernel_lock.node_owners[getCurrentCPUIndex()].queued;
+}
+#endif /* CONFIG_LOCK_MCS */
+
+#ifdef CONFIG_LOCK_TICKET
+static inline void FORCE_INLINE clh_lock_enqueue(word_t cpu, bool_t irqPath)
+{
+    big_kernel_lock.node_owners[cpu].queued = 1;
+    big_kernel_lock.node_owners[cpu].ticket =
+        __atomic_fetch_add(&big_kernel_lock.next_ticket.value, 1, __ATOMIC_RELAXED);
+}
+
+static inline bool_t FORCE_INLINE clh_lock_granted(word_t cpu)
+{
+    word_t ticket = big_kernel_lock.node_owners[cpu].ticket;
+    word_t serving = __atomic_load_n(&big_kernel_lock.now_serving.value, __ATOMIC_RELAXED);
+
+    if (serving == ticket) {
+        return true;
+    }
+
+    /* wait in proportion to the number of cores ahead of us, but keep
+     * responding to remote calls */
+    for (word_t i = (ticket - serving) * CONFIG_LOCK_TICKET_BACKOFF; i > 0; i--) {
+        if (clh_is_ipi_pending(cpu)) {
+            break;
+        }
+        arch_pause();
+    }
+
+    return false;
+}
+
+static inline void FORCE_INLINE clh_lock_handoff(word_t cpu)
+{
+    big_kernel_lock.node_owners[cpu].queued = 0;
+    __atomic_store_n(&big_kernel_lock.now_serving.value,
+                     big_kernel_lock.node_owners[cpu].ticket + 1, __ATOMIC_RELAXED);
+}
+
+static inline bool_t FORCE_INLINE clh_is_self_in_queue(void)
+{
+    return big_kernel_lock.node_owners[getCurrentCPUIndex()].queued;
+}
+#endif /* CONFIG_LOCK_TICKET */
+
+#ifdef CONFIG_LOCK_COHORT
+static inline void FORCE_INLINE clh_lock_enqueue(word_t cpu, bool_t irqPath)
+{
+    cohort_cluster_t *cluster = &big_kernel_lock.clusters[COHORT_CLUSTER(cpu)];
+
+    big_kernel_lock.node_owners[cpu].queued = 1;
+    big_kernel_lock.node_owners[cpu].state = CohortState_Local;
+    big_kernel_lock.node_owners[cpu].ticket =
+        __atomic_fetch_add(&cluster->next_ticket.value, 1, __ATOMIC_RELAXED);
+}
+
+static inline bool_t FORCE_INLINE clh_lock_granted(word_t cpu)
+{
+    cohort_lock_node_t *node = &big_kernel_lock.node_owners[cpu];
+    cohort_cluster_t *cluster = &big_kernel_lock.clusters[COHORT_CLUSTER(cpu)];
+
+    if (node->state == CohortState_Held) {
+        return true;
+    }
+
+    if (node->state == CohortState_Local) {
+        if (__atomic_load_n(&cluster->now_serving.value, __ATOMIC_ACQUIRE) != node->ticket) {
+            return false;
+        }
+        if (cluster->owns_global) {
+            /* the previous holder in our cluster passed us the global lock */
+            node->state = CohortState_Held;
+            return true;
+        }
+        cluster->global_ticket = __atomic_fetch_add(&big_kernel_lock.next_ticket.value, 1,
+                                                    __ATOMIC_RELAXED);
+        node->state = CohortState_Global;
+    }
+
+    if (__atomic_load_n(&big_kernel_lock.now_serving.value, __ATOMIC_RELAXED) !=
+        cluster->global_ticket) {
+        return false;
+    }
+    cluster->owns_global = 1;
+    cluster->handoffs = 0;
+    node->state = CohortState_Held;
+    return true;
+}
+
+static inline void FORCE_INLINE clh_lock_handoff(word_t cpu)
+{
+    cohort_lock_node_t *node = &big_kernel_lock.node_owners[cpu];
+    cohort_cluster_t *cluster = &big_kernel_lock.clusters[COHORT_CLUSTER(cpu)];
+    bool_t waiters = __atomic_load_n(&cluster->next_ticket.value, __ATOMIC_RELAXED) != node->ticket + 1;
+
+    node->queued = 0;
+
+    if (waiters && cluster->handoffs < CONFIG_LOCK_COHORT_MAX_HANDOFFS) {
+        /* keep the global lock in this cluster */
+        cluster->handoffs++;
+    } else {
+        cluster->owns_global = 0;
+        __atomic_store_n(&big_kernel_lock.now_serving.value, cluster->global_ticket + 1,
+                         __ATOMIC_RELAXED);
+    }
+
+    /* publishes owns_global to the next waiter of this cluster */
+    __atomic_store_n(&cluster->now_serving.value, node->ticket + 1, __ATOMIC_RELEASE);
+}
+
+static inline bool_t FORCE_INLINE clh_is_self_in_queue(void)
+{
+    return big_kernel_lock.node_owners[getCurrentCPUIndex()].queued;
+}
+#endif /* CONFIG_LOCK_COHORT */
+
+static inline void FORCE_INLINE clh_lock_acquire(word_t cpu, bool_t irqPath)
+{
+#ifdef CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION
+    benchmark_lock_wait(cpu);
+#endif
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_utilisation_lock_wait(cpu);
+#endif
+    clh_lock_enqueue(cpu, irqPath);
 
     /* We do not have an __atomic_thread_fence here as this is already handled by the
-     * atomic_exchange just above */
-    while (big_kernel_lock.node_owners[cpu].next->value != CLHState_Granted) {
+     * atomic operation used to join the queue */
+    while (!clh_lock_granted(cpu)) {
         /* As we are in a loop we need to ensure that any loads of future iterations of the
          * loop are performed after this one */
         __atomic_thread_fence(__ATOMIC_ACQUIRE);
@@ -113,21 +497,32 @@ static inline void FORCE_INLINE clh_lock_acquire(word_t cpu, bool_t irqPath)
 
     /* make sure no resource access passes from this point */
     __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+#ifdef CONFIG_FASTPATH_FINE_GRAINED_LOCKING
+    fastpath_lock_drain(cpu);
+#endif
+
+#ifdef CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION
+    benchmark_lock_acquired(cpu);
+#endif
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+    benchmark_utilisation_lock_acquired(cpu);
+#endif
 }
 
 static inline void FORCE_INLINE clh_lock_release(word_t cpu)
 {
+#ifdef CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION
+    benchmark_lock_release(cpu);
+#endif
+#ifdef CONFIG_FASTPATH_FINE_GRAINED_LOCKING
+    fastpath_lock_undrain();
+#endif
+
     /* make sure no resource access passes from this point */
     __atomic_thread_fence(__ATOMIC_RELEASE);
 
-    big_kernel_lock.node_owners[cpu].node->value = CLHState_Granted;
-    big_kernel_lock.node_owners[cpu].node =
-        big_kernel_lock.node_owners[cpu].next;
-}
-
-static inline bool_t FORCE_INLINE clh_is_self_in_queue(void)
-{
-    return big_kernel_lock.node_owners[getCurrentCPUIndex()].node->value == CLHState_Pending;
+    clh_lock_handoff(cpu);
 }
 
 #define NODE_LOCK(_irqPath) do {                         \
@@ -144,19 +539,117 @@ static inline bool_t FORCE_INLINE clh_is_self_in_queue(void)
     }                                                    \
 } while(0)
 
+#ifdef CONFIG_FASTPATH_FINE_GRAINED_LOCKING
+/* Enter a fastpath without the big kernel lock, unless some core holds it */
+static inline void FORCE_INLINE fastpath_lock_acquire(word_t cpu)
+{
+    __atomic_store_n(&fastpath_lock.nodes[cpu].active, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (unlikely(__atomic_load_n(&fastpath_lock.exclusive, __ATOMIC_ACQUIRE))) {
+        __atomic_store_n(&fastpath_lock.nodes[cpu].active, 0, __ATOMIC_RELEASE);
+        clh_lock_acquire(cpu, false);
+    }
+}
+
+static inline void FORCE_INLINE fastpath_object_lock(word_t cpu, void *object)
+{
+    word_t *lock = &fastpath_lock.objects[((word_t)object >> 4) & MASK(FASTPATH_OBJECT_LOCK_BITS)].locked;
+
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+            arch_pause();
+        }
+    }
+    fastpath_lock.nodes[cpu].held = lock;
+}
+
+static inline void FORCE_INLINE fastpath_object_unlock(word_t cpu)
+{
+    word_t *lock = fastpath_lock.nodes[cpu].held;
+
+    if (lock) {
+        fastpath_lock.nodes[cpu].held = NULL;
+        __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+    }
+}
+
+/* Leave a fastpath for the slowpath, which needs the big kernel lock */
+static inline void FORCE_INLINE fastpath_lock_fallback(word_t cpu)
+{
+    fastpath_object_unlock(cpu);
+    if (fastpath_lock.nodes[cpu].active) {
+        __atomic_store_n(&fastpath_lock.nodes[cpu].active, 0, __ATOMIC_RELEASE);
+        clh_lock_acquire(cpu, false);
+    }
+}
+
+static inline void FORCE_INLINE fastpath_lock_release(word_t cpu)
+{
+    fastpath_object_unlock(cpu);
+    if (likely(fastpath_lock.nodes[cpu].active)) {
+        __atomic_store_n(&fastpath_lock.nodes[cpu].active, 0, __ATOMIC_RELEASE);
+    } else {
+        clh_lock_release(cpu);
+    }
+}
+
+#define NODE_LOCK_FASTPATH do {                          \
+    fastpath_lock_acquire(getCurrentCPUIndex());         \
+} while(0)
+
+#define NODE_LOCK_SLOWPATH do {                          \
+    fastpath_lock_fallback(getCurrentCPUIndex());        \
+} while(0)
+
+#define NODE_UNLOCK_FASTPATH do {                        \
+    fastpath_lock_release(getCurrentCPUIndex());         \
+} while(0)
+
+#define FASTPATH_LOCK_OBJECT(_obj) do {                  \
+    fastpath_object_lock(getCurrentCPUIndex(), (_obj));  \
+} while(0)
+
+#define FASTPATH_UNLOCK_OBJECT do {                      \
+    fastpath_object_unlock(getCurrentCPUIndex());        \
+} while(0)
+
+#define NODE_LOCK_HELD                                   \
+    (fastpath_lock.nodes[getCurrentCPUIndex()].active    \
+     || clh_is_self_in_queue())
+
+#define NODE_UNLOCK_IF_HELD do {                         \
+    fastpath_object_unlock(getCurrentCPUIndex());        \
+    if(NODE_LOCK_HELD) {                                 \
+        NODE_UNLOCK_FASTPATH;                            \
+    }                                                    \
+} while(0)
+#else
+#define NODE_LOCK_HELD clh_is_self_in_queue()
+
 #define NODE_UNLOCK_IF_HELD do {                         \
     if(clh_is_self_in_queue()) {                         \
         NODE_UNLOCK;                                     \
     }                                                    \
 } while(0)
+#endif /* CONFIG_FASTPATH_FINE_GRAINED_LOCKING */
 
 #else
 #define NODE_LOCK(_irq) do {} while (0)
 #define NODE_UNLOCK do {} while (0)
 #define NODE_LOCK_IF(_cond, _irq) do {} while (0)
 #define NODE_UNLOCK_IF_HELD do {} while (0)
+#define NODE_LOCK_HELD true
 #endif /* ENABLE_SMP_SUPPORT */
 
+#ifndef CONFIG_FASTPATH_FINE_GRAINED_LOCKING
+#define NODE_LOCK_FASTPATH NODE_LOCK(false)
+#define NODE_LOCK_SLOWPATH do {} while (0)
+#define NODE_UNLOCK_FASTPATH NODE_UNLOCK
+#define FASTPATH_LOCK_OBJECT(_obj) do {} while (0)
+#define FASTPATH_UNLOCK_OBJECT do {} while (0)
+#endif /* !CONFIG_FASTPATH_FINE_GRAINED_LOCKING */
+
 #define NODE_LOCK_SYS NODE_LOCK(false)
 #define NODE_LOCK_IRQ NODE_LOCK(true)
 #define NODE_LOCK_SYS_IF(_cond) NODE_LOCK_IF(_cond, false)
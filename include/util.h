@@ -24,6 +24,7 @@
 
 /* time constants */
 #define MS_IN_S     1000llu
+#define US_IN_MS    1000llu
 
 #ifndef __ASSEMBLER__
 
@@ -541,4 +541,21 @@ LIBSEL4_INLINE_FUNC void seL4_SetTLSBase(seL4_Word tls_base)
 }
 #endif /* CONFIG_SET_TLS_BASE_SELF */
 
+#ifdef CONFIG_BATCH_INVOCATIONS
+LIBSEL4_INLINE_FUNC seL4_Word seL4_CallBatch(void)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word unused3 = 0;
+    seL4_Word unused4 = 0;
+    seL4_Word count;
+
+    riscv_sys_send_recv(seL4_SysCallBatch, 0, &count, 0, &unused0, &unused1, &unused2,
+                        &unused3, &unused4);
+
+    return count;
+}
+#endif /* CONFIG_BATCH_INVOCATIONS */
+
 #endif
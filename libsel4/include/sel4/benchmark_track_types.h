@@ -19,7 +19,8 @@
 #include <autoconf.h>
 #endif
 
-#if (defined CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES || defined CONFIG_DEBUG_BUILD)
+#if (defined CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES || defined CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION \
+     || defined CONFIG_DEBUG_BUILD)
 
 /* the following code can be used at any point in the kernel
  * to determine detail about the kernel entry point */
@@ -61,7 +62,7 @@ typedef struct SEL4_PACKED kernel_entry {
     };
 } kernel_entry_t;
 
-#endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES || DEBUG */
+#endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES || CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION || DEBUG */
 
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
 
@@ -73,4 +74,19 @@ typedef struct benchmark_syscall_log_entry {
 
 #endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES || CONFIG_DEBUG_BUILD */
 
+#ifdef CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION
+
+/* One acquisition of the kernel lock. Times are in timestamp counter
+ * cycles of the acquiring core. */
+typedef struct benchmark_lock_log_entry {
+    uint64_t  wait_start;
+    uint32_t  wait;
+    uint32_t  hold;
+    uint32_t  core;
+    /* The kernel entry that held the lock */
+    kernel_entry_t entry;
+} benchmark_track_lock_entry_t;
+
+#endif /* CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION */
+
 #endif /* BENCHMARK_TRACK_TYPES_H */
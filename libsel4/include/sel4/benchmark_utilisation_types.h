@@ -22,8 +22,38 @@ enum benchmark_track_util_ipc_index {
     BENCHMARK_TCB_UTILISATION,
     BENCHMARK_IDLE_LOCALCPU_UTILISATION,
     BENCHMARK_IDLE_TCBCPU_UTILISATION,
-    BENCHMARK_TOTAL_UTILISATION
+    BENCHMARK_TOTAL_UTILISATION,
+    /* Reschedule IPIs dropped because the target core already had one pending */
+    BENCHMARK_RESCHEDULE_IPIS_SUPPRESSED
 };
 
+/* Time spent by a core in each state, as written to the IPC buffer by
+ * seL4_BenchmarkGetCoreUtilisation for every core in turn */
+enum benchmark_core_util_ipc_index {
+    /* Running threads other than the idle thread */
+    BENCHMARK_CORE_USER,
+    /* In the kernel, excluding the two below */
+    BENCHMARK_CORE_KERNEL,
+    /* Running the idle thread */
+    BENCHMARK_CORE_IDLE,
+    /* Waiting to acquire the kernel lock */
+    BENCHMARK_CORE_LOCK_WAIT,
+    /* Handling interrupts */
+    BENCHMARK_CORE_IRQ,
+    BENCHMARK_CORE_NUM_COUNTERS
+};
+
+/* Each counter takes 64 / seL4_WordBits message registers, least
+ * significant word first. Cores are written one after another, starting
+ * with the core passed to seL4_BenchmarkGetCoreUtilisation.
+ * BENCHMARK_CORE_UTILISATION_INDEX is the first register of a counter of the
+ * n-th core written. */
+#define BENCHMARK_CORE_COUNTER_WORDS (sizeof(uint64_t) / sizeof(seL4_Word))
+#define BENCHMARK_CORE_WORDS (BENCHMARK_CORE_NUM_COUNTERS * BENCHMARK_CORE_COUNTER_WORDS)
+#define BENCHMARK_CORE_UTILISATION_INDEX(n, counter) \
+    ((n) * BENCHMARK_CORE_WORDS + (counter) * BENCHMARK_CORE_COUNTER_WORDS)
+/* The most cores written by a single call */
+#define BENCHMARK_CORES_PER_CALL (seL4_MsgMaxLength / BENCHMARK_CORE_WORDS)
+
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 #endif /* BENCHMARK_TRACK_UTIL_TYPES_H */
@@ -79,4 +79,22 @@ typedef enum {
     SEL4_FORCE_LONG_ENUM(seL4_LookupFailureType),
 } seL4_LookupFailureType;
 
+#ifdef CONFIG_BATCH_INVOCATIONS
+/* Format of the message of seL4_CallBatch. The result array holds one
+ * seL4_Error per record and is followed by the records themselves. */
+enum seL4_BatchMsg {
+    seL4_Batch_Count,
+    seL4_Batch_Next,
+    seL4_Batch_Results
+};
+
+/* Format of a single record of a batch. The extra cap cptrs are followed
+ * by the arguments of the invocation. */
+enum seL4_BatchRecordMsg {
+    seL4_BatchRecord_Info,
+    seL4_BatchRecord_CPtr,
+    seL4_BatchRecord_ExtraCaps
+};
+#endif
+
 #endif /* __API_CONSTANTS_H */
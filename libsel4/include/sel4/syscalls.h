@@ -405,7 +405,8 @@ seL4_DebugRun(void (* userfn)(void *), void *userarg);
  *    2. `BENCHMARK_TRACK_KERNEL_ENTRIES`:  as above,
  *    3. `BENCHMARK_TRACK_UTILISATION`: resets benchmark and current thread
  *        start time (to the time of invoking this syscall), resets idle
- *        thread utilisation to 0, and starts tracking utilisation.
+ *        thread utilisation and the per core breakdown to 0, and starts
+ *        tracking utilisation.
  *
  * @return A `seL4_Error` error if the user-level log buffer has not been set by the user
  *                         (`BENCHMARK_TRACEPOINTS`/`BENCHMARK_TRACK_KERNEL_ENTRIES`).
@@ -486,6 +487,24 @@ seL4_BenchmarkGetThreadUtilisation(seL4_Word tcb_cptr);
  */
 LIBSEL4_INLINE_FUNC void
 seL4_BenchmarkResetThreadUtilisation(seL4_Word tcb_cptr);
+
+/**
+ * @xmlonly <manual name="Get Core Utilisation" label="sel4_benchmarkgetcoreutilisation"/> @endxmlonly
+ * @brief Get a per core breakdown of utilisation.
+ *
+ * Starting at the given core, write the time each core has spent in user level, in the kernel,
+ * in the idle thread, waiting for the kernel lock and handling interrupts since the last
+ * `seL4_BenchmarkResetLog` into the caller's IPC buffer. As many cores are written as fit in the
+ * message registers (`BENCHMARK_CORES_PER_CALL`), so that they are all read together on most
+ * systems. Each 64-bit value takes `BENCHMARK_CORE_COUNTER_WORDS` words, least significant word
+ * first, starting at `BENCHMARK_CORE_UTILISATION_INDEX` of the core's position in the reply and
+ * its `benchmark_core_util_ipc_index` counter.
+ *
+ * @param[in] first_core The index of the first core to report on.
+ * @return The number of cores written. Zero if `first_core` is not a valid core index.
+ */
+LIBSEL4_INLINE_FUNC seL4_Word
+seL4_BenchmarkGetCoreUtilisation(seL4_Word first_core);
 #endif
 #endif
 /** @} */
@@ -571,4 +590,28 @@ LIBSEL4_INLINE_FUNC void
 seL4_SetTLSBase(seL4_Word tls_base);
 #endif
 
+#ifdef CONFIG_BATCH_INVOCATIONS
+/**
+ * @xmlonly <manual name="CallBatch" label="sel4_callbatch"/> @endxmlonly
+ * @brief Perform a batch of object invocations in a single kernel entry.
+ *
+ * The message registers of the IPC buffer hold the number of records in
+ * `seL4_Batch_Count`, the index of the first record to perform in
+ * `seL4_Batch_Next` (normally 0), an array of one result per record starting
+ * at `seL4_Batch_Results` and then the records. Each record consists of the
+ * `seL4_MessageInfo_t` of the invocation, the invoked cptr, one cptr per extra
+ * cap and the arguments of the invocation, in that order.
+ *
+ * Records are performed in order as if invoked with `seL4_Send`, and the
+ * `seL4_Error` of each is stored in the result array. Endpoint, notification
+ * and reply caps cannot be invoked from a batch. The kernel may be preempted
+ * between records, in which case `seL4_Batch_Next` records the progress made
+ * and the batch resumes from there.
+ *
+ * @return The number of records performed.
+ */
+LIBSEL4_INLINE_FUNC seL4_Word
+seL4_CallBatch(void);
+#endif
+
 #endif /* __LIBSEL4_SYSCALLS_H */
@@ -657,6 +657,18 @@ LIBSEL4_INLINE_FUNC void seL4_BenchmarkResetThreadUtilisation(seL4_Word tcb_cptr
 
     x86_sys_send_recv(seL4_SysBenchmarkResetThreadUtilisation, tcb_cptr, &unused0, 0, &unused1, &unused2, &unused3);
 }
+
+LIBSEL4_INLINE_FUNC seL4_Word seL4_BenchmarkGetCoreUtilisation(seL4_Word first_core)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word num_written;
+
+    x86_sys_send_recv(seL4_SysBenchmarkGetCoreUtilisation, first_core, &num_written, 0, &unused0, &unused1, &unused2);
+
+    return num_written;
+}
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 #endif /* CONFIG_ENABLE_BENCHMARKS */
 
@@ -668,4 +680,18 @@ LIBSEL4_INLINE_FUNC void seL4_SetTLSBase(seL4_Word tls_base)
 }
 #endif /* CONFIG_SET_TLS_BASE_SELF */
 
+#ifdef CONFIG_BATCH_INVOCATIONS
+LIBSEL4_INLINE_FUNC seL4_Word seL4_CallBatch(void)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word count;
+
+    x86_sys_send_recv(seL4_SysCallBatch, 0, &count, 0, &unused0, &unused1, &unused2);
+
+    return count;
+}
+#endif /* CONFIG_BATCH_INVOCATIONS */
+
 #endif
@@ -492,6 +492,21 @@ LIBSEL4_INLINE_FUNC void seL4_BenchmarkResetThreadUtilisation(seL4_Word tcb_cptr
     x64_sys_send_recv(seL4_SysBenchmarkResetThreadUtilisation, tcb_cptr, &unused0, 0, &unused1, &unused2, &unused3,
                       &unused4, &unused5);
 }
+
+LIBSEL4_INLINE_FUNC seL4_Word seL4_BenchmarkGetCoreUtilisation(seL4_Word first_core)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word unused3 = 0;
+    seL4_Word unused4 = 0;
+    seL4_Word num_written;
+
+    x64_sys_send_recv(seL4_SysBenchmarkGetCoreUtilisation, first_core, &num_written, 0, &unused0, &unused1, &unused2,
+                      &unused3, &unused4);
+
+    return num_written;
+}
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 #endif /* CONFIG_ENABLE_BENCHMARKS */
 
@@ -503,4 +518,20 @@ LIBSEL4_INLINE_FUNC void seL4_SetTLSBase(seL4_Word tls_base)
 }
 #endif /* CONFIG_SET_TLS_BASE_SELF */
 
+#ifdef CONFIG_BATCH_INVOCATIONS
+LIBSEL4_INLINE_FUNC seL4_Word seL4_CallBatch(void)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word unused3 = 0;
+    seL4_Word unused4 = 0;
+    seL4_Word count;
+
+    x64_sys_send_recv(seL4_SysCallBatch, 0, &count, 0, &unused0, &unused1, &unused2, &unused3, &unused4);
+
+    return count;
+}
+#endif /* CONFIG_BATCH_INVOCATIONS */
+
 #endif /* __LIBSEL4_SEL4_SEL4_ARCH_SYSCALLS_H_ */
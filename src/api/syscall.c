@@ -32,6 +32,10 @@
 #include <arch/machine/capdl.h>
 #endif
 
+#ifdef CONFIG_BATCH_INVOCATIONS
+#include <model/preemption.h>
+#endif
+
 /* The haskell function 'handleEvent' is split into 'handleXXX' variants
  * for each event causing a kernel entry */
 
@@ -39,11 +43,21 @@ exception_t handleInterruptEntry(void)
 {
     irq_t irq;
 
+#ifdef CONFIG_TICKLESS
+    timerTicksElapsed();
+#endif /* CONFIG_TICKLESS */
+
     irq = getActiveIRQ();
 
     if (irq != irqInvalid) {
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+        benchmark_core_utilisation_irq_start();
+#endif
         handleInterrupt(irq);
         Arch_finaliseInterrupt();
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+        benchmark_core_utilisation_irq_end();
+#endif
     } else {
 #ifdef CONFIG_IRQ_REPORTING
         userError("Spurious interrupt!");
@@ -57,8 +71,182 @@ exception_t handleInterruptEntry(void)
     return EXCEPTION_NONE;
 }
 
+#ifdef CONFIG_BATCH_INVOCATIONS
+word_t *current_batch_args;
+word_t current_batch_length;
+
+/* Perform a single record of a batch as a non-blocking send. Failures
+ * that the slowpath would report as faults are reported as errors. */
+static exception_t handleBatchRecord(tcb_t *thread, word_t *record, syscall_error_type_t *result)
+{
+    seL4_MessageInfo_t info;
+    cptr_t cptr;
+    lookupCapAndSlot_ret_t lu_ret;
+    lookupSlot_raw_ret_t extra_ret;
+    word_t *args;
+    word_t length, extraCaps, i;
+    exception_t status;
+
+    info = messageInfoFromWord(record[seL4_BatchRecord_Info]);
+    cptr = record[seL4_BatchRecord_CPtr];
+    length = seL4_MessageInfo_get_length(info);
+    extraCaps = seL4_MessageInfo_get_extraCaps(info);
+
+    lu_ret = lookupCapAndSlot(thread, cptr);
+    if (unlikely(lu_ret.status != EXCEPTION_NONE)) {
+        userError("CallBatch: invocation of invalid cap #%lu.", cptr);
+        *result = seL4_FailedLookup;
+        return EXCEPTION_NONE;
+    }
+
+    /* IPC would block or reply in the middle of the batch */
+    switch (cap_get_capType(lu_ret.cap)) {
+    case cap_endpoint_cap:
+    case cap_notification_cap:
+    case cap_reply_cap:
+        userError("CallBatch: IPC caps cannot be invoked from a batch.");
+        *result = seL4_IllegalOperation;
+        return EXCEPTION_NONE;
+
+    default:
+        break;
+    }
+
+    for (i = 0; i < extraCaps; i++) {
+        extra_ret = lookupSlot(thread, record[seL4_BatchRecord_ExtraCaps + i]);
+        if (unlikely(extra_ret.status != EXCEPTION_NONE)) {
+            userError("CallBatch: lookup of extra caps failed.");
+            *result = seL4_FailedLookup;
+            return EXCEPTION_NONE;
+        }
+        current_extra_caps.excaprefs[i] = extra_ret.slot;
+    }
+    if (i < seL4_MsgMaxExtraCaps) {
+        current_extra_caps.excaprefs[i] = NULL;
+    }
+
+    /* The decoders read their arguments with getSyscallArg, which takes
+     * them from this record rather than the message registers of the
+     * caller while a batch record is decoded */
+    args = record + seL4_BatchRecord_ExtraCaps + extraCaps;
+    current_batch_args = args;
+    current_batch_length = length;
+    status = decodeInvocation(seL4_MessageInfo_get_label(info), length,
+                              cptr, lu_ret.slot, lu_ret.cap,
+                              current_extra_caps, false, false,
+                              args - 1);
+    current_batch_args = NULL;
+
+    if (unlikely(status == EXCEPTION_PREEMPTED)) {
+        return status;
+    }
+
+    if (unlikely(status == EXCEPTION_SYSCALL_ERROR)) {
+        *result = current_syscall_error.type;
+        return EXCEPTION_NONE;
+    }
+
+    *result = seL4_NoError;
+    return EXCEPTION_NONE;
+}
+
+/* Perform the batch of invocations described in the IPC buffer of the
+ * current thread. Progress is recorded in the buffer after each record,
+ * so a preempted batch resumes where it stopped when it is restarted. */
+static exception_t handleBatchInvocation(void)
+{
+    tcb_t *thread;
+    word_t *buffer;
+    word_t count, next, offset, end, i;
+    seL4_MessageInfo_t info;
+    syscall_error_type_t result;
+    exception_t status;
+
+    thread = NODE_STATE(ksCurThread);
+
+    /* Message register i is at offset i + 1 in the IPC buffer */
+    buffer = lookupIPCBuffer(true, thread);
+    if (unlikely(!buffer)) {
+        userError("CallBatch: no IPC buffer.");
+        setRegister(thread, badgeRegister, 0);
+        return EXCEPTION_NONE;
+    }
+
+    count = buffer[seL4_Batch_Count + 1];
+    next = buffer[seL4_Batch_Next + 1];
+    if (unlikely(count > seL4_MsgMaxLength - seL4_Batch_Results)) {
+        userError("CallBatch: too many records (%lu).", count);
+        setRegister(thread, badgeRegister, 0);
+        return EXCEPTION_NONE;
+    }
+
+    offset = seL4_Batch_Results + count;
+    for (i = 0; i < count; i++) {
+        /* Check the record fits in the message */
+        if (unlikely(offset + seL4_BatchRecord_ExtraCaps > seL4_MsgMaxLength)) {
+            buffer[seL4_Batch_Results + i + 1] = seL4_RangeError;
+            break;
+        }
+        info = messageInfoFromWord(buffer[offset + seL4_BatchRecord_Info + 1]);
+        end = offset + seL4_BatchRecord_ExtraCaps + seL4_MessageInfo_get_extraCaps(info) +
+              seL4_MessageInfo_get_length(info);
+        if (unlikely(end > seL4_MsgMaxLength)) {
+            buffer[seL4_Batch_Results + i + 1] = seL4_RangeError;
+            break;
+        }
+
+        /* Skip records performed before the batch was preempted */
+        if (i >= next) {
+            status = handleBatchRecord(thread, buffer + offset + 1, &result);
+            if (unlikely(status == EXCEPTION_PREEMPTED)) {
+                return status;
+            }
+
+            /* Memory or ASIDs released by this record may be reused by the
+             * next one */
+            Arch_flushDeferredTranslations();
+
+            /* The invocation may have removed the IPC buffer, in which
+             * case record i was still performed */
+            buffer = lookupIPCBuffer(true, thread);
+            if (unlikely(!buffer)) {
+                userError("CallBatch: IPC buffer removed by batch.");
+                setRegister(thread, badgeRegister, i + 1);
+                return EXCEPTION_NONE;
+            }
+            buffer[seL4_Batch_Results + i + 1] = result;
+            buffer[seL4_Batch_Next + 1] = i + 1;
+
+            /* Complete the invocation as handleInvocation does, stopping
+             * if it has suspended the current thread. */
+            if (thread_state_get_tsType(thread->tcbState) == ThreadState_Restart) {
+                setThreadState(thread, ThreadState_Running);
+            } else if (unlikely(thread_state_get_tsType(thread->tcbState) != ThreadState_Running)) {
+                return EXCEPTION_NONE;
+            }
+
+            if (i + 1 < count) {
+                status = preemptionPoint();
+                if (unlikely(status != EXCEPTION_NONE)) {
+                    setThreadState(thread, ThreadState_Restart);
+                    return status;
+                }
+            }
+        }
+
+        offset = end;
+    }
+
+    setRegister(thread, badgeRegister, i);
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_BATCH_INVOCATIONS */
+
 exception_t handleUnknownSyscall(word_t w)
 {
+#ifdef CONFIG_TICKLESS
+    timerTicksElapsed();
+#endif /* CONFIG_TICKLESS */
 #ifdef CONFIG_PRINTING
     if (w == SysDebugPutChar) {
         kernel_putchar(getRegister(NODE_STATE(ksCurThread), capRegister));
@@ -196,6 +384,10 @@ exception_t handleUnknownSyscall(word_t w)
         NODE_STATE(ksCurThread)->benchmark.schedule_start_time = ksEnter;
         benchmark_start_time = ksEnter;
         benchmark_arch_utilisation_reset();
+#ifdef ENABLE_SMP_SUPPORT
+        ksRescheduleIPIsSuppressed = 0;
+#endif
+        benchmark_track_reset_core_utilisation();
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
         setRegister(NODE_STATE(ksCurThread), capRegister, seL4_NoError);
         return EXCEPTION_NONE;
@@ -229,6 +421,8 @@ exception_t handleUnknownSyscall(word_t w)
     } else if (w == SysBenchmarkResetThreadUtilisation) {
         benchmark_track_reset_utilisation();
         return EXCEPTION_NONE;
+    } else if (w == SysBenchmarkGetCoreUtilisation) {
+        return benchmark_track_core_utilisation_dump();
     }
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
 
@@ -260,6 +454,9 @@ exception_t handleUnknownSyscall(word_t w)
 
 exception_t handleUserLevelFault(word_t w_a, word_t w_b)
 {
+#ifdef CONFIG_TICKLESS
+    timerTicksElapsed();
+#endif /* CONFIG_TICKLESS */
     current_fault = seL4_Fault_UserException_new(w_a, w_b);
     handleFault(NODE_STATE(ksCurThread));
 
@@ -273,6 +470,10 @@ exception_t handleVMFaultEvent(vm_fault_type_t vm_faultType)
 {
     exception_t status;
 
+#ifdef CONFIG_TICKLESS
+    timerTicksElapsed();
+#endif /* CONFIG_TICKLESS */
+
     status = handleVMFault(NODE_STATE(ksCurThread), vm_faultType);
     if (status != EXCEPTION_NONE) {
         handleFault(NODE_STATE(ksCurThread));
@@ -458,6 +659,10 @@ exception_t handleSyscall(syscall_t syscall)
     exception_t ret;
     irq_t irq;
 
+#ifdef CONFIG_TICKLESS
+    timerTicksElapsed();
+#endif /* CONFIG_TICKLESS */
+
     switch (syscall) {
     case SysSend:
         ret = handleInvocation(false, true);
@@ -513,6 +718,19 @@ exception_t handleSyscall(syscall_t syscall)
         handleYield();
         break;
 
+#ifdef CONFIG_BATCH_INVOCATIONS
+    case SysCallBatch:
+        ret = handleBatchInvocation();
+        if (unlikely(ret != EXCEPTION_NONE)) {
+            irq = getActiveIRQ();
+            if (irq != irqInvalid) {
+                handleInterrupt(irq);
+                Arch_finaliseInterrupt();
+            }
+        }
+        break;
+#endif /* CONFIG_BATCH_INVOCATIONS */
+
     default:
         fail("Invalid syscall");
     }
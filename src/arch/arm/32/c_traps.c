@@ -24,6 +24,11 @@
 /** DONT_TRANSLATE */
 void VISIBLE NORETURN restore_user_context(void)
 {
+#ifdef CONFIG_HAVE_FPU
+    /* FPU state may only be saved with the lock held */
+    lazyFPURestore(NODE_STATE(ksCurThread));
+#endif /* CONFIG_HAVE_FPU */
+
     NODE_UNLOCK_IF_HELD;
 
     word_t cur_thread_reg = (word_t) NODE_STATE(ksCurThread);
@@ -34,10 +39,6 @@ void VISIBLE NORETURN restore_user_context(void)
     restore_user_debug_context(NODE_STATE(ksCurThread));
 #endif
 
-#ifdef CONFIG_HAVE_FPU
-    lazyFPURestore(NODE_STATE(ksCurThread));
-#endif /* CONFIG_HAVE_FPU */
-
     if (config_set(CONFIG_ARM_HYPERVISOR_SUPPORT)) {
         asm volatile(
             /* Set stack pointer to point at the r0 of the user context. */
@@ -24,14 +24,15 @@
 /** DONT_TRANSLATE */
 void VISIBLE NORETURN restore_user_context(void)
 {
-    NODE_UNLOCK_IF_HELD;
-
-    c_exit_hook();
-
 #ifdef CONFIG_HAVE_FPU
+    /* FPU state may only be saved with the lock held */
     lazyFPURestore(NODE_STATE(ksCurThread));
 #endif /* CONFIG_HAVE_FPU */
 
+    NODE_UNLOCK_IF_HELD;
+
+    c_exit_hook();
+
     asm volatile(
         "mov     sp, %0                     \n"
 
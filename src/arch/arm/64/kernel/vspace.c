@@ -22,6 +22,7 @@
 #include <machine/io.h>
 #include <machine/debug.h>
 #include <model/statedata.h>
+#include <model/preemption.h>
 #include <object/cnode.h>
 #include <object/untyped.h>
 #include <arch/api/invocation.h>
@@ -1191,6 +1192,24 @@ static inline void invalidateTLBByASIDVA(asid_t asid, vptr_t vaddr)
 #endif
 }
 
+/* Invalidate 'count' consecutive translations of size BIT(pageBits)
+ * starting at vaddr with a single flush. */
+static inline void invalidateTLBByASIDRange(asid_t asid, vptr_t vaddr, word_t count, word_t pageBits)
+{
+#ifdef CONFIG_ARM_HYPERVISOR_SUPPORT
+    pgde_t stored_hw_asid;
+
+    stored_hw_asid = loadHWASID(asid);
+    if (!pgde_pgde_invalid_get_stored_asid_valid(stored_hw_asid)) {
+        return;
+    }
+    uint64_t hw_asid = pgde_pgde_invalid_get_stored_hw_asid(stored_hw_asid);
+    invalidateTranslationRange((hw_asid << 48) | vaddr >> seL4_PageBits, count, pageBits);
+#else
+    invalidateTranslationRange((asid << 48) | vaddr >> seL4_PageBits, count, pageBits);
+#endif
+}
+
 pde_t *pageTableMapped(asid_t asid, vptr_t vaddr, pte_t *pt)
 {
     findVSpaceForASID_ret_t find_ret;
@@ -1253,24 +1272,18 @@ void unmapPageTable(asid_t asid, vptr_t vaddr, pte_t *pt)
     }
 }
 
-void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
+/* Clear the entry mapping addr at vptr, leaving TLB maintenance to the
+ * caller. Returns whether an entry was cleared, i.e. whether the caller
+ * has a translation to flush. */
+static bool_t unmapPageEntry(vm_page_size_t page_size, pgde_t *pgd, vptr_t vptr, paddr_t addr)
 {
-    paddr_t addr;
-    findVSpaceForASID_ret_t find_ret;
-
-    addr = pptr_to_paddr((void *)pptr);
-    find_ret = findVSpaceForASID(asid);
-    if (unlikely(find_ret.status != EXCEPTION_NONE)) {
-        return;
-    }
-
     switch (page_size) {
     case ARMSmallPage: {
         lookupPTSlot_ret_t lu_ret;
 
-        lu_ret = lookupPTSlot(find_ret.vspace_root, vptr);
+        lu_ret = lookupPTSlot(pgd, vptr);
         if (unlikely(lu_ret.status != EXCEPTION_NONE)) {
-            return;
+            return false;
         }
 
         if (pte_ptr_get_present(lu_ret.ptSlot) &&
@@ -1278,16 +1291,17 @@ void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
             *(lu_ret.ptSlot) = pte_invalid_new();
 
             cleanByVA_PoU((vptr_t)lu_ret.ptSlot, pptr_to_paddr(lu_ret.ptSlot));
+            return true;
         }
-        break;
+        return false;
     }
 
     case ARMLargePage: {
         lookupPDSlot_ret_t lu_ret;
 
-        lu_ret = lookupPDSlot(find_ret.vspace_root, vptr);
+        lu_ret = lookupPDSlot(pgd, vptr);
         if (unlikely(lu_ret.status != EXCEPTION_NONE)) {
-            return;
+            return false;
         }
 
         if (pde_pde_large_ptr_get_present(lu_ret.pdSlot) &&
@@ -1295,16 +1309,17 @@ void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
             *(lu_ret.pdSlot) = pde_invalid_new();
 
             cleanByVA_PoU((vptr_t)lu_ret.pdSlot, pptr_to_paddr(lu_ret.pdSlot));
+            return true;
         }
-        break;
+        return false;
     }
 
     case ARMHugePage: {
         lookupPUDSlot_ret_t lu_ret;
 
-        lu_ret = lookupPUDSlot(find_ret.vspace_root, vptr);
+        lu_ret = lookupPUDSlot(pgd, vptr);
         if (unlikely(lu_ret.status != EXCEPTION_NONE)) {
-            return;
+            return false;
         }
 
         if (pude_pude_1g_ptr_get_present(lu_ret.pudSlot) &&
@@ -1312,12 +1327,28 @@ void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
             *(lu_ret.pudSlot) = pude_invalid_new();
 
             cleanByVA_PoU((vptr_t)lu_ret.pudSlot, pptr_to_paddr(lu_ret.pudSlot));
+            return true;
         }
-        break;
+        return false;
     }
 
     default:
         fail("Invalid ARM page type");
+        return false;
+    }
+}
+
+void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
+{
+    findVSpaceForASID_ret_t find_ret;
+
+    find_ret = findVSpaceForASID(asid);
+    if (unlikely(find_ret.status != EXCEPTION_NONE)) {
+        return;
+    }
+
+    if (!unmapPageEntry(page_size, find_ret.vspace_root, vptr, pptr_to_paddr((void *)pptr))) {
+        return;
     }
 
     assert(asid < BIT(16));
@@ -1594,6 +1625,148 @@ static exception_t performPageGetAddress(pptr_t base_ptr)
     return EXCEPTION_NONE;
 }
 
+static exception_t performPageGlobalDirectoryMapRange(pgde_t *pgd, asid_t asid, cte_t *slots, word_t count,
+                                                      vptr_t vaddr, seL4_CapRights_t rightsMask,
+                                                      vm_attributes_t attributes)
+{
+    exception_t status = EXCEPTION_NONE;
+    word_t mapped;
+
+    for (mapped = 0; mapped < count && status == EXCEPTION_NONE; mapped++) {
+        cte_t *cte = &slots[mapped];
+        cap_t cap = cte->cap;
+        vm_page_size_t frameSize;
+        vm_rights_t vmRights;
+        paddr_t base;
+
+        /* Stop at the first slot that cannot be mapped; the caller
+         * learns how far we got from the reply. */
+        if (cap_get_capType(cap) != cap_frame_cap ||
+            cap_frame_cap_get_capFMappedASID(cap) != 0) {
+            break;
+        }
+
+        frameSize = cap_frame_cap_get_capFSize(cap);
+        if (!IS_PAGE_ALIGNED(vaddr, frameSize) ||
+            vaddr + BIT(pageBitsForSize(frameSize)) - 1 > USER_TOP) {
+            break;
+        }
+
+        vmRights = maskVMRights(cap_frame_cap_get_capFVMRights(cap), rightsMask);
+        base = pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(cap));
+        cap = cap_frame_cap_set_capFMappedASID(cap, asid);
+        cap = cap_frame_cap_set_capFMappedAddress(cap, vaddr);
+
+        /* Only empty slots are filled, so no TLB maintenance is needed */
+        if (frameSize == ARMSmallPage) {
+            lookupPTSlot_ret_t lu_ret = lookupPTSlot(pgd, vaddr);
+
+            if (lu_ret.status != EXCEPTION_NONE || pte_ptr_get_present(lu_ret.ptSlot)) {
+                break;
+            }
+            performSmallPageInvocationMap(asid, cap, cte,
+                                          makeUser3rdLevel(base, vmRights, attributes), lu_ret.ptSlot);
+        } else if (frameSize == ARMLargePage) {
+            lookupPDSlot_ret_t lu_ret = lookupPDSlot(pgd, vaddr);
+
+            if (lu_ret.status != EXCEPTION_NONE ||
+                pde_pde_small_ptr_get_present(lu_ret.pdSlot) ||
+                pde_pde_large_ptr_get_present(lu_ret.pdSlot)) {
+                break;
+            }
+            performLargePageInvocationMap(asid, cap, cte,
+                                          makeUser2ndLevel(base, vmRights, attributes), lu_ret.pdSlot);
+        } else {
+            lookupPUDSlot_ret_t lu_ret = lookupPUDSlot(pgd, vaddr);
+
+            if (lu_ret.status != EXCEPTION_NONE ||
+                pude_pude_pd_ptr_get_present(lu_ret.pudSlot) ||
+                pude_pude_1g_ptr_get_present(lu_ret.pudSlot)) {
+                break;
+            }
+            performHugePageInvocationMap(asid, cap, cte,
+                                         makeUser1stLevel(base, vmRights, attributes), lu_ret.pudSlot);
+        }
+
+        vaddr += BIT(pageBitsForSize(frameSize));
+        status = preemptionPoint();
+    }
+
+    setRegister(NODE_STATE(ksCurThread), msgRegisters[0], mapped);
+    setRegister(NODE_STATE(ksCurThread), msgInfoRegister,
+                wordFromMessageInfo(seL4_MessageInfo_new(0, 0, 0, 1)));
+    /* Keep handleInvocation from replacing the reply. If we were preempted
+     * the caller reissues the invocation for the remaining frames. */
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Running);
+
+    return status;
+}
+
+static exception_t performPageGlobalDirectoryUnmapRange(pgde_t *pgd, asid_t asid, cte_t *slots, word_t count)
+{
+    exception_t status = EXCEPTION_NONE;
+    vptr_t runStart = 0;
+    word_t runCount = 0, runBits = 0;
+    word_t flushed = 0;
+    word_t unmapped;
+
+    for (unmapped = 0; unmapped < count && status == EXCEPTION_NONE; unmapped++) {
+        cap_t cap = slots[unmapped].cap;
+        vm_page_size_t frameSize;
+        vptr_t vaddr;
+
+        /* Stop at the first slot that is not a frame mapped into this PGD */
+        if (cap_get_capType(cap) != cap_frame_cap ||
+            cap_frame_cap_get_capFMappedASID(cap) != asid) {
+            break;
+        }
+
+        frameSize = cap_frame_cap_get_capFSize(cap);
+        vaddr = cap_frame_cap_get_capFMappedAddress(cap);
+        if (unmapPageEntry(frameSize, pgd, vaddr,
+                           pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(cap)))) {
+            word_t pageBits = pageBitsForSize(frameSize);
+
+            /* Collect cleared entries into runs of contiguous frames of one
+             * size, and flush a run only when the next entry does not
+             * extend it. Past the threshold the whole ASID is dropped
+             * below instead. */
+            if (flushed < CONFIG_RANGE_FLUSH_MAX_PAGES) {
+                if (runCount != 0 &&
+                    (pageBits != runBits || vaddr != runStart + (runCount << runBits))) {
+                    invalidateTLBByASIDRange(asid, runStart, runCount, runBits);
+                    runCount = 0;
+                }
+                if (runCount == 0) {
+                    runStart = vaddr;
+                    runBits = pageBits;
+                }
+                runCount++;
+            }
+            flushed++;
+        }
+
+        cap_frame_cap_ptr_set_capFMappedASID(&slots[unmapped].cap, asidInvalid);
+        cap_frame_cap_ptr_set_capFMappedAddress(&slots[unmapped].cap, 0);
+
+        status = preemptionPoint();
+    }
+
+    assert(asid < BIT(16));
+    if (flushed > CONFIG_RANGE_FLUSH_MAX_PAGES) {
+        invalidateTLBByASID(asid);
+    } else if (runCount != 0) {
+        invalidateTLBByASIDRange(asid, runStart, runCount, runBits);
+    }
+
+    setRegister(NODE_STATE(ksCurThread), msgRegisters[0], unmapped);
+    setRegister(NODE_STATE(ksCurThread), msgInfoRegister,
+                wordFromMessageInfo(seL4_MessageInfo_new(0, 0, 0, 1)));
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Running);
+
+    return status;
+}
+
 static exception_t performASIDPoolInvocation(asid_t asid, asid_pool_t *poolPtr, cte_t *vspaceCapSlot)
 {
     cap_page_global_directory_cap_ptr_set_capPGDMappedASID(&vspaceCapSlot->cap, asid);
@@ -1624,6 +1797,53 @@ static exception_t performASIDControlInvocation(void *frame, cte_t *slot,
     return EXCEPTION_NONE;
 }
 
+/* Check that cap is a usable PGD and that slots [index, index + count) lie
+ * within cnodeCap, which is passed as the first extra cap. */
+static exception_t checkPageGlobalDirectoryRange(cap_t cap, cap_t cnodeCap, word_t index, word_t count)
+{
+    findVSpaceForASID_ret_t find_ret;
+    word_t radix;
+
+    if (unlikely(!isValidNativeRoot(cap))) {
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    find_ret = findVSpaceForASID(cap_page_global_directory_cap_get_capPGDMappedASID(cap));
+    if (unlikely(find_ret.status != EXCEPTION_NONE)) {
+        userError("PGD Range: No PGD for ASID");
+        current_syscall_error.type = seL4_FailedLookup;
+        current_syscall_error.failedLookupWasSource = false;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(find_ret.vspace_root != PGDE_PTR(cap_page_global_directory_cap_get_capPGDBasePtr(cap)))) {
+        userError("PGD Range: Invalid PGD Cap");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(cap_get_capType(cnodeCap) != cap_cnode_cap)) {
+        userError("PGD Range: Frames must be supplied in a CNode.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    radix = cap_cnode_cap_get_capCNodeRadix(cnodeCap);
+    if (unlikely(count > BIT(radix) || index > BIT(radix) - count)) {
+        userError("PGD Range: Slot range outside CNode.");
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = BIT(radix);
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    return EXCEPTION_NONE;
+}
+
 static exception_t decodeARMPageGlobalDirectoryInvocation(word_t invLabel, unsigned int length,
                                                           cte_t *cte, cap_t cap, extra_caps_t extraCaps,
                                                           word_t *buffer)
@@ -1716,6 +1936,69 @@ static exception_t decodeARMPageGlobalDirectoryInvocation(word_t invLabel, unsig
         setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
         return performPageGlobalDirectoryFlush(invLabel, pgd, asid, start, end - 1, pstart);
 
+    case ARMPageGlobalDirectoryMapRange: {
+        exception_t status;
+        word_t index, count;
+        vptr_t vaddr;
+        cap_t cnodeCap;
+
+        if (unlikely(length < 5 || extraCaps.excaprefs[0] == NULL)) {
+            userError("PGD MapRange: Truncated message.");
+            current_syscall_error.type = seL4_TruncatedMessage;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        index = getSyscallArg(0, buffer);
+        count = getSyscallArg(1, buffer);
+        vaddr = getSyscallArg(2, buffer);
+        cnodeCap = extraCaps.excaprefs[0]->cap;
+
+        status = checkPageGlobalDirectoryRange(cap, cnodeCap, index, count);
+        if (unlikely(status != EXCEPTION_NONE)) {
+            return status;
+        }
+
+        if (unlikely(vaddr > USER_TOP)) {
+            userError("PGD MapRange: Exceed the user addressable region.");
+            current_syscall_error.type = seL4_InvalidArgument;
+            current_syscall_error.invalidArgumentNumber = 2;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+        return performPageGlobalDirectoryMapRange(PGDE_PTR(cap_page_global_directory_cap_get_capPGDBasePtr(cap)),
+                                                  cap_page_global_directory_cap_get_capPGDMappedASID(cap),
+                                                  CTE_PTR(cap_cnode_cap_get_capCNodePtr(cnodeCap)) + index, count,
+                                                  vaddr, rightsFromWord(getSyscallArg(3, buffer)),
+                                                  vmAttributesFromWord(getSyscallArg(4, buffer)));
+    }
+
+    case ARMPageGlobalDirectoryUnmapRange: {
+        exception_t status;
+        word_t index, count;
+        cap_t cnodeCap;
+
+        if (unlikely(length < 2 || extraCaps.excaprefs[0] == NULL)) {
+            userError("PGD UnmapRange: Truncated message.");
+            current_syscall_error.type = seL4_TruncatedMessage;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        index = getSyscallArg(0, buffer);
+        count = getSyscallArg(1, buffer);
+        cnodeCap = extraCaps.excaprefs[0]->cap;
+
+        status = checkPageGlobalDirectoryRange(cap, cnodeCap, index, count);
+        if (unlikely(status != EXCEPTION_NONE)) {
+            return status;
+        }
+
+        setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+        return performPageGlobalDirectoryUnmapRange(PGDE_PTR(cap_page_global_directory_cap_get_capPGDBasePtr(cap)),
+                                                    cap_page_global_directory_cap_get_capPGDMappedASID(cap),
+                                                    CTE_PTR(cap_cnode_cap_get_capCNodePtr(cnodeCap)) + index, count);
+    }
+
     default:
         current_syscall_error.type = seL4_IllegalOperation;
         return EXCEPTION_SYSCALL_ERROR;
@@ -28,8 +28,8 @@ void VISIBLE NORETURN c_handle_undefined_instruction(void)
     c_entry_hook();
 
 #ifdef TRACK_KERNEL_ENTRIES
-    ksKernelEntry.path = Entry_UserLevelFault;
-    ksKernelEntry.word = getRegister(NODE_STATE(ksCurThread), NextIP);
+    NODE_STATE(ksKernelEntry).path = Entry_UserLevelFault;
+    NODE_STATE(ksKernelEntry).word = getRegister(NODE_STATE(ksCurThread), NextIP);
 #endif
 
 #if defined(CONFIG_HAVE_FPU) && defined(CONFIG_ARCH_AARCH32)
@@ -60,6 +60,8 @@ void VISIBLE NORETURN c_handle_undefined_instruction(void)
 #if defined(CONFIG_HAVE_FPU) && defined(CONFIG_ARCH_AARCH64)
 void VISIBLE NORETURN c_handle_enfp(void)
 {
+    NODE_LOCK_SYS;
+
     c_entry_hook();
 
     handleFPUFault();
@@ -74,12 +76,16 @@ static inline void NORETURN c_handle_vm_fault(vm_fault_type_t type)
     c_entry_hook();
 
 #ifdef TRACK_KERNEL_ENTRIES
-    ksKernelEntry.path = Entry_VMFault;
-    ksKernelEntry.word = getRegister(NODE_STATE(ksCurThread), NextIP);
+    NODE_STATE(ksKernelEntry).path = Entry_VMFault;
+    NODE_STATE(ksKernelEntry).word = getRegister(NODE_STATE(ksCurThread), NextIP);
 #endif
 
+#ifdef CONFIG_VM_FAULT_FASTPATH
+    fastpath_vm_fault(type);
+#else
     handleVMFaultEvent(type);
     restore_user_context();
+#endif
     UNREACHABLE();
 }
 
@@ -99,10 +105,10 @@ void VISIBLE NORETURN c_handle_interrupt(void)
     c_entry_hook();
 
 #ifdef TRACK_KERNEL_ENTRIES
-    ksKernelEntry.path = Entry_Interrupt;
-    ksKernelEntry.word = getActiveIRQ();
+    NODE_STATE(ksKernelEntry).path = Entry_Interrupt;
+    NODE_STATE(ksKernelEntry).word = getActiveIRQ();
 #ifdef ENABLE_SMP_SUPPORT
-    ksKernelEntry.core = getCurrentCPUIndex();
+    NODE_STATE(ksKernelEntry).core = getCurrentCPUIndex();
 #endif
 #endif
 
@@ -112,8 +118,10 @@ void VISIBLE NORETURN c_handle_interrupt(void)
 
 void NORETURN slowpath(syscall_t syscall)
 {
+    NODE_LOCK_SLOWPATH;
+
 #ifdef TRACK_KERNEL_ENTRIES
-    ksKernelEntry.is_fastpath = 0;
+    NODE_STATE(ksKernelEntry).is_fastpath = 0;
 #endif /* TRACK KERNEL ENTRIES */
     handleSyscall(syscall);
 
@@ -123,12 +131,12 @@ void NORETURN slowpath(syscall_t syscall)
 
 void VISIBLE c_handle_syscall(word_t cptr, word_t msgInfo, syscall_t syscall)
 {
-    NODE_LOCK_SYS;
+    NODE_LOCK_FASTPATH;
 
     c_entry_hook();
 #ifdef TRACK_KERNEL_ENTRIES
     benchmark_debug_syscall_start(cptr, msgInfo, syscall);
-    ksKernelEntry.is_fastpath = 1;
+    NODE_STATE(ksKernelEntry).is_fastpath = 1;
 #endif /* DEBUG */
 
 #ifdef CONFIG_FASTPATH
@@ -139,11 +147,24 @@ void VISIBLE c_handle_syscall(word_t cptr, word_t msgInfo, syscall_t syscall)
         fastpath_reply_recv(cptr, msgInfo);
         UNREACHABLE();
     }
+#if defined(CONFIG_SEND_FASTPATH) || defined(CONFIG_SIGNAL_FASTPATH)
+    else if (syscall == SysSend || syscall == SysNBSend) {
+        fastpath_send(cptr, msgInfo, syscall);
+        UNREACHABLE();
+    }
+#endif /* CONFIG_SEND_FASTPATH || CONFIG_SIGNAL_FASTPATH */
+#ifdef CONFIG_RECV_FASTPATH
+    else if (syscall == SysRecv || syscall == SysNBRecv) {
+        fastpath_recv(cptr, msgInfo, syscall);
+        UNREACHABLE();
+    }
+#endif /* CONFIG_RECV_FASTPATH */
 #endif /* CONFIG_FASTPATH */
 
     if (unlikely(syscall < SYSCALL_MIN || syscall > SYSCALL_MAX)) {
+        NODE_LOCK_SLOWPATH;
 #ifdef TRACK_KERNEL_ENTRIES
-        ksKernelEntry.path = Entry_UnknownSyscall;
+        NODE_STATE(ksKernelEntry).path = Entry_UnknownSyscall;
         /* ksKernelEntry.word word is already set to syscall */
 #endif /* TRACK_KERNEL_ENTRIES */
         handleUnknownSyscall(syscall);
@@ -163,8 +184,8 @@ VISIBLE NORETURN void c_handle_vcpu_fault(word_t hsr)
     c_entry_hook();
 
 #ifdef TRACK_KERNEL_ENTRIES
-    ksKernelEntry.path = Entry_VCPUFault;
-    ksKernelEntry.word = hsr;
+    NODE_STATE(ksKernelEntry).path = Entry_VCPUFault;
+    NODE_STATE(ksKernelEntry).word = hsr;
 #endif
     handleVCPUFault(hsr);
     restore_user_context();
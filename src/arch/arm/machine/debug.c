@@ -1080,8 +1080,8 @@ bool_t isDebugFault(word_t hsr_or_fsr)
 seL4_Fault_t handleUserLevelDebugException(word_t fault_vaddr)
 {
 #ifdef TRACK_KERNEL_ENTRIES
-    ksKernelEntry.path = Entry_DebugFault;
-    ksKernelEntry.word = fault_vaddr;
+    NODE_STATE(ksKernelEntry).path = Entry_DebugFault;
+    NODE_STATE(ksKernelEntry).word = fault_vaddr;
 #endif
 
     word_t method_of_entry = getMethodOfEntry();
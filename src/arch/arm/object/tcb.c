@@ -30,10 +30,8 @@ exception_t CONST Arch_performTransfer(word_t arch, tcb_t *tcb_src, tcb_t *tcb_d
 void Arch_migrateTCB(tcb_t *thread)
 {
 #ifdef CONFIG_HAVE_FPU
-    /* check if thread own its current core FPU */
-    if (nativeThreadUsingFPU(thread)) {
-        switchFpuOwner(NULL, thread->tcbAffinity);
-    }
+    /* save the thread's FPU state if it is live on any core */
+    fpuThreadMigrate(thread);
 #endif /* CONFIG_HAVE_FPU */
 }
 #endif /* ENABLE_SMP_SUPPORT */
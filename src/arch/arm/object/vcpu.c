@@ -742,6 +742,9 @@ exception_t invokeVCPUSetTCB(vcpu_t *vcpu, tcb_t *tcb)
 
 void handleVCPUFault(word_t hsr)
 {
+#ifdef CONFIG_TICKLESS
+    timerTicksElapsed();
+#endif /* CONFIG_TICKLESS */
 #ifdef CONFIG_ARCH_AARCH64
     if (armv_handleVCPUFault(hsr)) {
         return;
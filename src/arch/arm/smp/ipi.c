@@ -12,66 +12,51 @@
 
 #include <config.h>
 #include <mode/smp/ipi.h>
+#include <machine/fpu.h>
 #include <smp/lock.h>
 #include <util.h>
 
 #ifdef ENABLE_SMP_SUPPORT
 
-static IpiModeRemoteCall_t remoteCall;   /* the remote call being requested */
-
-static inline void init_ipi_args(IpiModeRemoteCall_t func,
-                                 word_t data1, word_t data2, word_t data3,
-                                 word_t mask)
-{
-    remoteCall = func;
-    ipi_args[0] = data1;
-    ipi_args[1] = data2;
-    ipi_args[2] = data3;
-
-    /* get number of cores involved in this IPI */
-    totalCoreBarrier = popcountl(mask);
-}
-
 static void handleRemoteCall(IpiModeRemoteCall_t call, word_t arg0,
                              word_t arg1, word_t arg2, bool_t irqPath)
 {
-    /* we gets spurious irq_remote_call_ipi calls, e.g. when handling IPI
-     * in lock while hardware IPI is pending. Guard against spurious IPIs! */
-    if (clh_is_ipi_pending(getCurrentCPUIndex())) {
-        switch ((IpiRemoteCall_t)call) {
-        case IpiRemoteCall_Stall:
-            ipiStallCoreCallback(irqPath);
-            break;
+    switch ((IpiRemoteCall_t)call) {
+    case IpiRemoteCall_Stall:
+        ipiStallCoreCallback(irqPath);
+        break;
 
-#ifdef CONFIG_HAVE_FPU
-        case IpiRemoteCall_switchFpuOwner:
-            switchLocalFpuOwner((user_fpu_state_t *)arg0);
-            break;
-#endif /* CONFIG_HAVE_FPU */
+    case IpiRemoteCall_InvalidateTranslationSingle:
+        invalidateTranslationSingleLocal(arg0);
+        break;
 
-        case IpiRemoteCall_InvalidateTranslationSingle:
-            invalidateTranslationSingleLocal(arg0);
-            break;
+    case IpiRemoteCall_InvalidateTranslationASID:
+        invalidateTranslationASIDLocal(arg0);
+        break;
 
-        case IpiRemoteCall_InvalidateTranslationASID:
-            invalidateTranslationASIDLocal(arg0);
-            break;
+#ifdef CONFIG_ARCH_AARCH64
+    case IpiRemoteCall_InvalidateTranslationRange:
+        invalidateTranslationRangeLocal(arg0, arg1, arg2);
+        break;
+#endif
 
-        case IpiRemoteCall_InvalidateTranslationAll:
-            invalidateTranslationAllLocal();
-            break;
+    case IpiRemoteCall_InvalidateTranslationAll:
+        invalidateTranslationAllLocal();
+        break;
 
-        case IpiRemoteCall_MaskPrivateInterrupt:
-            maskInterrupt(arg0, arg1);
-            break;
+#ifdef CONFIG_HAVE_FPU
+    case IpiRemoteCall_ReleaseFpuState:
+        handleRemoteFpuRelease((user_fpu_state_t *)arg0);
+        break;
+#endif /* CONFIG_HAVE_FPU */
 
-        default:
-            fail("Invalid remote call");
-            break;
-        }
+    case IpiRemoteCall_MaskPrivateInterrupt:
+        maskInterrupt(arg0, arg1);
+        break;
 
-        big_kernel_lock.node_owners[getCurrentCPUIndex()].ipi = 0;
-        ipi_wait(totalCoreBarrier);
+    default:
+        fail("Invalid remote call");
+        break;
     }
 }
 
@@ -121,8 +121,13 @@ void VISIBLE NORETURN c_handle_exception(void)
     case RISCVLoadPageFault:
     case RISCVStorePageFault:
     case RISCVInstructionPageFault:
+#ifdef CONFIG_VM_FAULT_FASTPATH
+        fastpath_vm_fault(scause);
+        UNREACHABLE();
+#else
         handleVMFaultEvent(scause);
         break;
+#endif
     default:
         handleUserLevelFault(scause, 0);
         break;
@@ -160,6 +165,18 @@ void VISIBLE NORETURN c_handle_syscall(word_t cptr, word_t msgInfo, word_t unuse
         fastpath_reply_recv(cptr, msgInfo);
         UNREACHABLE();
     }
+#if defined(CONFIG_SEND_FASTPATH) || defined(CONFIG_SIGNAL_FASTPATH)
+    else if (syscall == (syscall_t)SysSend || syscall == (syscall_t)SysNBSend) {
+        fastpath_send(cptr, msgInfo, syscall);
+        UNREACHABLE();
+    }
+#endif /* CONFIG_SEND_FASTPATH || CONFIG_SIGNAL_FASTPATH */
+#ifdef CONFIG_RECV_FASTPATH
+    else if (syscall == (syscall_t)SysRecv || syscall == (syscall_t)SysNBRecv) {
+        fastpath_recv(cptr, msgInfo, syscall);
+        UNREACHABLE();
+    }
+#endif /* CONFIG_RECV_FASTPATH */
 #endif /* CONFIG_FASTPATH */
     slowpath(syscall);
     UNREACHABLE();
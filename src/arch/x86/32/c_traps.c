@@ -12,6 +12,7 @@
 #include <model/statedata.h>
 #include <kernel/stack.h>
 #include <machine/fpu.h>
+#include <arch/kernel/tlb.h>
 #include <arch/fastpath/fastpath.h>
 #include <arch/machine/debug.h>
 #include <benchmark/benchmark_track.h>
@@ -112,6 +113,9 @@ void NORETURN VISIBLE restore_user_context(void)
 {
     c_exit_hook();
 
+    SMP_COND_STATEMENT(flushTranslationBatch());
+    /* FPU state may only be saved with the lock held */
+    lazyFPURestore(NODE_STATE(ksCurThread));
     NODE_UNLOCK_IF_HELD;
 
     /* we've now 'exited' the kernel. If we have a pending interrupt
@@ -139,7 +143,6 @@ void NORETURN VISIBLE restore_user_context(void)
     }
 #endif
     setKernelEntryStackPointer(NODE_STATE(ksCurThread));
-    lazyFPURestore(NODE_STATE(ksCurThread));
 
 #ifdef CONFIG_HARDWARE_DEBUG_API
     restore_user_debug_context(NODE_STATE(ksCurThread));
@@ -13,6 +13,7 @@
 #include <config.h>
 #include <model/statedata.h>
 #include <machine/fpu.h>
+#include <arch/kernel/tlb.h>
 #include <kernel/traps.h>
 #include <arch/machine/debug.h>
 #include <kernel/stack.h>
@@ -134,6 +135,16 @@ static void NORETURN restore_vmx(void)
 
 void VISIBLE NORETURN restore_user_context(void)
 {
+    SMP_COND_STATEMENT(flushTranslationBatch());
+    /* FPU state may only be saved with the lock held. The FPU of a thread
+     * running a VM is switched by the VCPU code instead. */
+#ifdef CONFIG_VTX
+    if (thread_state_ptr_get_tsType(&NODE_STATE(ksCurThread)->tcbState) != ThreadState_RunningVM) {
+        lazyFPURestore(NODE_STATE(ksCurThread));
+    }
+#else
+    lazyFPURestore(NODE_STATE(ksCurThread));
+#endif
     NODE_UNLOCK_IF_HELD;
     c_exit_hook();
 
@@ -162,7 +173,6 @@ void VISIBLE NORETURN restore_user_context(void)
         restore_vmx();
     }
 #endif
-    lazyFPURestore(cur_thread);
 
 #ifdef CONFIG_HARDWARE_DEBUG_API
     restore_user_debug_context(cur_thread);
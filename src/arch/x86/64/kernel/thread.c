@@ -48,6 +48,11 @@ BOOT_CODE void Arch_configureIdleThread(tcb_t *tcb)
      * thread will have a valid RSP, and never 0). See traps.S for the other side of this
      */
     setRegister(tcb, RSP, 0);
+#ifdef CONFIG_X86_IDLE_MWAIT
+    /* the idle thread cannot find its core without a stack, so pass it the
+     * address of the flag to monitor as its argument */
+    setRegister(tcb, RDI, (word_t)getRescheduleWakeWord(tcb->tcbAffinity));
+#endif /* CONFIG_X86_IDLE_MWAIT */
 }
 
 void Arch_switchToIdleThread(void)
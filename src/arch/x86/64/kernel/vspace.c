@@ -1422,6 +1422,12 @@ exception_t decodeX86ModeMMUInvocation(
     switch (cap_get_capType(cap)) {
 
     case cap_pml4_cap:
+        if (label == X86PML4MapRange) {
+            return decodeX86VSpaceMapRange(length, cap, extraCaps, buffer);
+        }
+        if (label == X86PML4UnmapRange) {
+            return decodeX86VSpaceUnmapRange(length, cap, extraCaps, buffer);
+        }
         current_syscall_error.type = seL4_IllegalOperation;
         return EXCEPTION_SYSCALL_ERROR;
 
@@ -281,6 +281,17 @@ config_option(
     DEPENDS "KernelArchX86;NOT KernelVerificationBuild"
 )
 
+config_option(
+    KernelX86IdleMwait X86_IDLE_MWAIT
+    "Idle threads wait with MONITOR/MWAIT on a per core flag instead of HLT. A core \
+    that makes a thread runnable on an idle core sets the flag instead of sending a \
+    reschedule IPI, and the woken idle thread enters the kernel with a software \
+    interrupt. Requires a CPU with MONITOR/MWAIT support."
+    DEFAULT OFF
+    DEPENDS "KernelSel4ArchX86_64;NOT KernelVerificationBuild;NOT ${KernelMaxNumNodes} EQUAL 1"
+    DEFAULT_DISABLED OFF
+)
+
 if(KernelArchX86 AND (NOT "${KernelMaxNumNodes}" EQUAL 1))
     set(STIBDEP TRUE)
 else()
@@ -12,9 +12,36 @@
 
 #include <config.h>
 #include <api/debug.h>
+#include <plat/machine.h>
 
 void idle_thread(void)
 {
+#ifdef CONFIG_X86_IDLE_MWAIT
+    /* %rdi holds this core's reschedule flag, see Arch_configureIdleThread.
+     * The monitor is armed before the flag is checked so a write between the
+     * check and the mwait is not missed. Once the flag is set we raise the
+     * reschedule vector ourselves; the resulting EOI is ignored by the APIC
+     * as no interrupt is in service. This must not touch the stack. */
+    asm volatile(
+        "1:\n"
+        "movq %%rdi, %%rax\n"
+        "xorl %%ecx, %%ecx\n"
+        "xorl %%edx, %%edx\n"
+        "monitor\n"
+        "cmpq $0, (%%rdi)\n"
+        "jne 2f\n"
+        "xorl %%eax, %%eax\n"
+        "mwait\n"
+        "cmpq $0, (%%rdi)\n"
+        "je 1b\n"
+        "2:\n"
+        "int %[vector]\n"
+        "jmp 1b\n"
+        :
+        : [vector] "i"(int_reschedule_ipi)
+        : "rax", "rcx", "rdx", "memory"
+    );
+#endif /* CONFIG_X86_IDLE_MWAIT */
     while (1) {
         asm volatile("hlt");
     }
@@ -32,6 +59,10 @@ void VISIBLE halt(void)
     debug_printKernelEntryReason();
 #endif
 #endif
-    idle_thread();
+    /* software interrupts are not masked, so don't wait on the reschedule
+     * flag like the idle thread */
+    while (1) {
+        asm volatile("hlt");
+    }
     UNREACHABLE();
 }
@@ -117,7 +117,11 @@ BOOT_CODE bool_t apic_init(bool_t mask_legacy_irqs)
     apic_write_reg(
         APIC_LVT_TIMER,
         apic_lvt_new(
+#ifdef CONFIG_TICKLESS
+            2,        /* timer_mode      */
+#else
             1,        /* timer_mode      */
+#endif
             0,        /* masked          */
             0,        /* trigger_mode    */
             0,        /* remote_irr      */
@@ -309,6 +309,9 @@ BOOT_CODE bool_t init_sys_state(
     init_irqs(root_cnode_cap);
 
     tsc_freq = tsc_init();
+#ifdef CONFIG_TICKLESS
+    x86KStscMhz = tsc_freq;
+#endif
 
     /* populate the bootinfo frame */
     populate_bi_frame(0, ksNumCPUs, ipcbuf_vptr, extra_bi_size);
@@ -522,6 +525,20 @@ BOOT_CODE bool_t init_cpu(
         return false;
     }
 
+#ifdef CONFIG_X86_IDLE_MWAIT
+    if (!(x86_cpuid_ecx(1, 0) & BIT(3))) {
+        printf("MONITOR/MWAIT not supported by CPU\n");
+        return false;
+    }
+#endif /* CONFIG_X86_IDLE_MWAIT */
+
+#ifdef CONFIG_TICKLESS
+    if (!(x86_cpuid_ecx(1, 0) & BIT(24))) {
+        printf("APIC TSC-deadline mode not supported by CPU\n");
+        return false;
+    }
+#endif /* CONFIG_TICKLESS */
+
 #ifdef CONFIG_HARDWARE_DEBUG_API
     /* Initialize hardware breakpoints */
     Arch_initHardwareBreakpoints();
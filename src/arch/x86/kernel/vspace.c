@@ -13,6 +13,7 @@
 #include <machine/io.h>
 #include <kernel/boot.h>
 #include <model/statedata.h>
+#include <model/preemption.h>
 #include <arch/kernel/vspace.h>
 #include <arch/api/invocation.h>
 #include <arch/kernel/tlb_bitmap.h>
@@ -53,8 +54,21 @@ void deleteASIDPool(asid_t asid_base, asid_pool_t *pool)
     }
 }
 
+/* Complete the remote TLB invalidations deferred so far in this kernel
+ * entry. Other cores may still hold translations for memory or ASIDs
+ * released earlier in the entry, so this must be done before they are
+ * reused. */
+void Arch_flushDeferredTranslations(void)
+{
+#ifdef ENABLE_SMP_SUPPORT
+    flushTranslationBatch();
+#endif /* ENABLE_SMP_SUPPORT */
+}
+
 exception_t performASIDControlInvocation(void *frame, cte_t *slot, cte_t *parent, asid_t asid_base)
 {
+    Arch_flushDeferredTranslations();
+
     /** AUXUPD: "(True, typ_region_bytes (ptr_val \<acute>frame) 12)" */
     /** GHOSTUPD: "(True, gs_clear_region (ptr_val \<acute>frame) 12)" */
     cap_untyped_cap_ptr_set_capFreeIndex(&(parent->cap),
@@ -703,59 +717,73 @@ void flushTable(vspace_root_t *vspace, word_t vptr, pte_t *pt, asid_t asid)
 }
 
 
-void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr)
+/* Clear the entry mapping pptr at vptr, leaving TLB maintenance to the
+ * caller. Returns true if an entry was cleared. */
+static bool_t unmapPageEntry(vm_page_size_t page_size, vspace_root_t *vspace, vptr_t vptr, void *pptr)
 {
-    findVSpaceForASID_ret_t find_ret;
     lookupPTSlot_ret_t  lu_ret;
-    cap_t               threadRoot;
     lookupPDSlot_ret_t  pd_ret;
     pde_t               *pde;
 
-    find_ret = findVSpaceForASID(asid);
-    if (find_ret.status != EXCEPTION_NONE) {
-        return;
-    }
-
     switch (page_size) {
     case X86_SmallPage:
-        lu_ret = lookupPTSlot(find_ret.vspace_root, vptr);
+        lu_ret = lookupPTSlot(vspace, vptr);
         if (lu_ret.status != EXCEPTION_NONE) {
-            return;
+            return false;
         }
         if (!(pte_ptr_get_present(lu_ret.ptSlot)
               && (pte_ptr_get_page_base_address(lu_ret.ptSlot)
                   == pptr_to_paddr(pptr)))) {
-            return;
+            return false;
         }
         *lu_ret.ptSlot = makeUserPTEInvalid();
-        break;
+        return true;
 
     case X86_LargePage:
-        pd_ret = lookupPDSlot(find_ret.vspace_root, vptr);
+        pd_ret = lookupPDSlot(vspace, vptr);
         if (pd_ret.status != EXCEPTION_NONE) {
-            return;
+            return false;
         }
         pde = pd_ret.pdSlot;
         if (!(pde_ptr_get_page_size(pde) == pde_pde_large
               && pde_pde_large_ptr_get_present(pde)
               && (pde_pde_large_ptr_get_page_base_address(pde)
                   == pptr_to_paddr(pptr)))) {
-            return;
+            return false;
         }
         *pde = makeUserPDEInvalid();
-        break;
+        return true;
 
     default:
-        if (!modeUnmapPage(page_size, find_ret.vspace_root, vptr, pptr)) {
-            return;
-        }
-        break;
+        return modeUnmapPage(page_size, vspace, vptr, pptr);
     }
+}
+
+/* Only the current address space can have stale translations without PCIDs */
+static bool_t vspaceNeedsTLBFlush(vspace_root_t *vspace)
+{
+    cap_t threadRoot;
 
-    /* check if page belongs to current address space */
     threadRoot = TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbVTable)->cap;
-    if (config_set(CONFIG_SUPPORT_PCID) || (isValidNativeRoot(threadRoot)
-                                            && (vspace_root_t *)pptr_of_cap(threadRoot) == find_ret.vspace_root)) {
+    return config_set(CONFIG_SUPPORT_PCID) || (isValidNativeRoot(threadRoot)
+                                               && (vspace_root_t *)pptr_of_cap(threadRoot) == vspace);
+}
+
+void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr)
+{
+    findVSpaceForASID_ret_t find_ret;
+
+    find_ret = findVSpaceForASID(asid);
+    if (find_ret.status != EXCEPTION_NONE) {
+        return;
+    }
+
+    if (!unmapPageEntry(page_size, find_ret.vspace_root, vptr, pptr)) {
+        return;
+    }
+
+    /* check if page belongs to current address space */
+    if (vspaceNeedsTLBFlush(find_ret.vspace_root)) {
         invalidateTranslationSingleASID(vptr, asid,
                                         SMP_TERNARY(tlb_bitmap_get(find_ret.vspace_root), 0));
     }
@@ -1229,6 +1257,264 @@ exception_t decodeX86FrameInvocation(
     }
 }
 
+static exception_t performX86VSpaceMapRange(cte_t *slots, word_t count, vspace_root_t *vspace, asid_t asid,
+                                            word_t vaddr, seL4_CapRights_t rightsMask, vm_attributes_t vmAttr)
+{
+    exception_t status = EXCEPTION_NONE;
+    word_t mapped;
+
+    for (mapped = 0; mapped < count && status == EXCEPTION_NONE; mapped++) {
+        cap_t          cap = slots[mapped].cap;
+        vm_page_size_t frameSize;
+        vm_rights_t    vmRights;
+        paddr_t        paddr;
+        word_t         vtop;
+
+        /* Stop at the first slot that cannot be mapped; the caller
+         * learns how far we got from the reply. */
+        if (cap_get_capType(cap) != cap_frame_cap ||
+            cap_frame_cap_get_capFMappedASID(cap) != asidInvalid) {
+            break;
+        }
+
+        frameSize = cap_frame_cap_get_capFSize(cap);
+        vtop = vaddr + BIT(pageBitsForSize(frameSize));
+        if (!checkVPAlignment(frameSize, vaddr) || vtop > PPTR_USER_TOP || vtop < vaddr) {
+            break;
+        }
+
+        vmRights = maskVMRights(cap_frame_cap_get_capFVMRights(cap), rightsMask);
+        paddr = pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(cap));
+
+        if (frameSize == X86_SmallPage) {
+            create_mapping_pte_return_t map_ret;
+
+            map_ret = createSafeMappingEntries_PTE(paddr, vaddr, vmRights, vmAttr, vspace);
+            if (map_ret.status != EXCEPTION_NONE) {
+                break;
+            }
+            /* do not replace an existing mapping */
+            if (pte_ptr_get_present(map_ret.ptSlot)) {
+                break;
+            }
+            *map_ret.ptSlot = map_ret.pte;
+        } else if (frameSize == X86_LargePage) {
+            create_mapping_pde_return_t map_ret;
+
+            map_ret = createSafeMappingEntries_PDE(paddr, vaddr, vmRights, vmAttr, vspace);
+            if (map_ret.status != EXCEPTION_NONE) {
+                break;
+            }
+            /* page tables are rejected above, large pages here */
+            if (pde_ptr_get_page_size(map_ret.pdSlot) == pde_pde_large &&
+                pde_pde_large_ptr_get_present(map_ret.pdSlot)) {
+                break;
+            }
+            *map_ret.pdSlot = map_ret.pde;
+        } else {
+            /* huge pages are left to X86PageMap */
+            break;
+        }
+
+        cap = cap_frame_cap_set_capFMappedASID(cap, asid);
+        cap = cap_frame_cap_set_capFMappedAddress(cap, vaddr);
+        cap = cap_frame_cap_set_capFMapType(cap, X86_MappingVSpace);
+        slots[mapped].cap = cap;
+
+        vaddr = vtop;
+        status = preemptionPoint();
+    }
+
+    /* One paging structure cache flush covers every entry written above */
+    if (mapped > 0) {
+        invalidatePageStructureCacheASID(pptr_to_paddr(vspace), asid,
+                                         SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+    }
+
+    setRegister(NODE_STATE(ksCurThread), msgRegisters[0], mapped);
+    setRegister(NODE_STATE(ksCurThread), msgInfoRegister,
+                wordFromMessageInfo(seL4_MessageInfo_new(0, 0, 0, 1)));
+    /* Force the thread to running so handleInvocation does not overwrite
+     * the reply. If we were preempted the caller sees a partial count and
+     * can reissue the invocation for the remaining frames. */
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Running);
+
+    return status;
+}
+
+/* Check that cap is a usable VSpace root and that slots [index, index + count)
+ * lie within cnodeCap, which is passed as the first extra cap. */
+static exception_t checkX86VSpaceRange(cap_t cap, cap_t cnodeCap, word_t index, word_t count)
+{
+    findVSpaceForASID_ret_t find_ret;
+    word_t radix;
+
+    if (!isValidNativeRoot(cap)) {
+        userError("X86VSpaceRange: Invalid VSpace cap.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 0;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    find_ret = findVSpaceForASID(cap_get_capMappedASID(cap));
+    if (find_ret.status != EXCEPTION_NONE) {
+        current_syscall_error.type = seL4_FailedLookup;
+        current_syscall_error.failedLookupWasSource = false;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (find_ret.vspace_root != (vspace_root_t *)pptr_of_cap(cap)) {
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 0;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (cap_get_capType(cnodeCap) != cap_cnode_cap) {
+        userError("X86VSpaceRange: Frames must be supplied in a CNode.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 1;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    radix = cap_cnode_cap_get_capCNodeRadix(cnodeCap);
+    if (count > BIT(radix) || index > BIT(radix) - count) {
+        userError("X86VSpaceRange: Slot range outside CNode.");
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = BIT(radix);
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    return EXCEPTION_NONE;
+}
+
+exception_t decodeX86VSpaceMapRange(word_t length, cap_t cap, extra_caps_t excaps, word_t *buffer)
+{
+    word_t          index;
+    word_t          count;
+    word_t          vaddr;
+    word_t          w_rightsMask;
+    cap_t           cnodeCap;
+    vm_attributes_t vmAttr;
+    exception_t     status;
+
+    if (length < 5 || excaps.excaprefs[0] == NULL) {
+        userError("X86VSpaceMapRange: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    index = getSyscallArg(0, buffer);
+    count = getSyscallArg(1, buffer);
+    vaddr = getSyscallArg(2, buffer);
+    w_rightsMask = getSyscallArg(3, buffer);
+    vmAttr = vmAttributesFromWord(getSyscallArg(4, buffer));
+    cnodeCap = excaps.excaprefs[0]->cap;
+
+    status = checkX86VSpaceRange(cap, cnodeCap, index, count);
+    if (status != EXCEPTION_NONE) {
+        return status;
+    }
+
+    if (vaddr >= PPTR_USER_TOP) {
+        userError("X86VSpaceMapRange: Mapping address too high.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 2;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return performX86VSpaceMapRange(CTE_PTR(cap_cnode_cap_get_capCNodePtr(cnodeCap)) + index, count,
+                                    (vspace_root_t *)pptr_of_cap(cap), cap_get_capMappedASID(cap),
+                                    vaddr, rightsFromWord(w_rightsMask), vmAttr);
+}
+
+static exception_t performX86VSpaceUnmapRange(cte_t *slots, word_t count, vspace_root_t *vspace, asid_t asid)
+{
+    exception_t status = EXCEPTION_NONE;
+    bool_t needsFlush = vspaceNeedsTLBFlush(vspace);
+    word_t flushed = 0;
+    word_t unmapped;
+
+    for (unmapped = 0; unmapped < count && status == EXCEPTION_NONE; unmapped++) {
+        cap_t  cap = slots[unmapped].cap;
+        vptr_t vaddr;
+
+        /* Stop at the first slot that is not a frame mapped into this VSpace */
+        if (cap_get_capType(cap) != cap_frame_cap ||
+            cap_frame_cap_get_capFMappedASID(cap) != asid ||
+            cap_frame_cap_get_capFMapType(cap) != X86_MappingVSpace) {
+            break;
+        }
+
+        vaddr = cap_frame_cap_get_capFMappedAddress(cap);
+        if (unmapPageEntry(cap_frame_cap_get_capFSize(cap), vspace, vaddr,
+                           (void *)cap_frame_cap_get_capFBasePtr(cap)) && needsFlush) {
+            /* A single invalidation drops the translation of a frame of
+             * any size, so only the entries actually cleared are flushed.
+             * Remote cores are sent the batch once, at the end of the
+             * kernel entry. Past the threshold the whole ASID is dropped
+             * below instead. */
+            if (flushed < CONFIG_RANGE_FLUSH_MAX_PAGES) {
+                invalidateTranslationSingleASID(vaddr, asid, SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+            }
+            flushed++;
+        }
+
+        cap_frame_cap_ptr_set_capFMappedAddress(&slots[unmapped].cap, 0);
+        cap_frame_cap_ptr_set_capFMappedASID(&slots[unmapped].cap, asidInvalid);
+        cap_frame_cap_ptr_set_capFMapType(&slots[unmapped].cap, X86_MappingNone);
+
+        status = preemptionPoint();
+    }
+
+    if (flushed > CONFIG_RANGE_FLUSH_MAX_PAGES) {
+        invalidateASID(vspace, asid, SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+    }
+
+    setRegister(NODE_STATE(ksCurThread), msgRegisters[0], unmapped);
+    setRegister(NODE_STATE(ksCurThread), msgInfoRegister,
+                wordFromMessageInfo(seL4_MessageInfo_new(0, 0, 0, 1)));
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Running);
+
+    return status;
+}
+
+exception_t decodeX86VSpaceUnmapRange(word_t length, cap_t cap, extra_caps_t excaps, word_t *buffer)
+{
+    word_t      index;
+    word_t      count;
+    cap_t       cnodeCap;
+    exception_t status;
+
+    if (length < 2 || excaps.excaprefs[0] == NULL) {
+        userError("X86VSpaceUnmapRange: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    index = getSyscallArg(0, buffer);
+    count = getSyscallArg(1, buffer);
+    cnodeCap = excaps.excaprefs[0]->cap;
+
+    status = checkX86VSpaceRange(cap, cnodeCap, index, count);
+    if (status != EXCEPTION_NONE) {
+        return status;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return performX86VSpaceUnmapRange(CTE_PTR(cap_cnode_cap_get_capCNodePtr(cnodeCap)) + index, count,
+                                      (vspace_root_t *)pptr_of_cap(cap), cap_get_capMappedASID(cap));
+}
+
 static exception_t performX86PageTableInvocationUnmap(cap_t cap, cte_t *ctSlot)
 {
 
@@ -1522,6 +1808,7 @@ exception_t decodeX86MMUInvocation(
         asid += i;
 
         setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+        Arch_flushDeferredTranslations();
         return performASIDPoolInvocation(asid, pool, vspaceCapSlot);
     }
 
@@ -49,6 +49,11 @@ user_fpu_state_t x86KSnullFpuState ALIGN(MIN_FPU_ALIGNMENT);
 /* Number of IOMMUs (DMA Remapping Hardware Units) */
 uint32_t x86KSnumDrhu;
 
+#ifdef CONFIG_TICKLESS
+/* TSC frequency, which the timer deadlines are measured in */
+uint32_t x86KStscMhz;
+#endif
+
 #ifdef CONFIG_IOMMU
 /* Intel VT-d Root Entry Table */
 vtd_rte_t *x86KSvtdRootTable;
@@ -88,9 +88,7 @@ exception_t decodeSetEPTRoot(cap_t cap, extra_caps_t excaps)
 #ifdef ENABLE_SMP_SUPPORT
 void Arch_migrateTCB(tcb_t *thread)
 {
-    /* check if thread own its current core FPU */
-    if (nativeThreadUsingFPU(thread)) {
-        switchFpuOwner(NULL, thread->tcbAffinity);
-    }
+    /* save the thread's FPU state if it is live on any core */
+    fpuThreadMigrate(thread);
 }
 #endif /* ENABLE_SMP_SUPPORT */
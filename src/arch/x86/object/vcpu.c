@@ -1153,6 +1153,10 @@ exception_t handleVmexit(void)
 
     NODE_LOCK_SYS;
 
+#ifdef CONFIG_TICKLESS
+    timerTicksElapsed();
+#endif /* CONFIG_TICKLESS */
+
     if (!vcpuThreadUsingFPU(NODE_STATE(ksCurThread))) {
         /* since this vcpu does not currently own the fpu state, check if the kernel should
          * switch the fpu owner or not. We switch if the guest performed and unimplemented device
@@ -14,70 +14,54 @@
 #include <mode/smp/ipi.h>
 #include <smp/ipi.h>
 #include <smp/lock.h>
+#include <arch/kernel/tlb.h>
+#include <machine/fpu.h>
 
 #ifdef ENABLE_SMP_SUPPORT
 
-static IpiModeRemoteCall_t remoteCall;   /* the remote call being requested */
-
-static inline void init_ipi_args(IpiModeRemoteCall_t func,
-                                 word_t data1, word_t data2, word_t data3,
-                                 word_t mask)
-{
-    remoteCall = func;
-    ipi_args[0] = data1;
-    ipi_args[1] = data2;
-    ipi_args[2] = data3;
-
-    /* get number of cores involved in this IPI */
-    totalCoreBarrier = popcountl(mask);
-}
-
 static void handleRemoteCall(IpiModeRemoteCall_t call, word_t arg0,
                              word_t arg1, word_t arg2, bool_t irqPath)
 {
-    /* we gets spurious irq_remote_call_ipi calls, e.g. when handling IPI
-     * in lock while hardware IPI is pending. Guard against spurious IPIs! */
-    if (clh_is_ipi_pending(getCurrentCPUIndex())) {
-        switch ((IpiRemoteCall_t)call) {
-        case IpiRemoteCall_Stall:
-            ipiStallCoreCallback(irqPath);
-            break;
-
-        case IpiRemoteCall_InvalidatePageStructureCacheASID:
-            invalidateLocalPageStructureCacheASID(arg0, arg1);
-            break;
-
-        case IpiRemoteCall_InvalidateTranslationSingle:
-            invalidateLocalTranslationSingle(arg0);
-            break;
-
-        case IpiRemoteCall_InvalidateTranslationSingleASID:
-            invalidateLocalTranslationSingleASID(arg0, arg1);
-            break;
-
-        case IpiRemoteCall_InvalidateTranslationAll:
-            invalidateLocalTranslationAll();
-            break;
-
-        case IpiRemoteCall_switchFpuOwner:
-            switchLocalFpuOwner((user_fpu_state_t *)arg0);
-            break;
+    switch ((IpiRemoteCall_t)call) {
+    case IpiRemoteCall_Stall:
+        ipiStallCoreCallback(irqPath);
+        break;
+
+    case IpiRemoteCall_InvalidatePageStructureCacheASID:
+        invalidateLocalPageStructureCacheASID(arg0, arg1);
+        break;
+
+    case IpiRemoteCall_InvalidateTranslationSingle:
+        invalidateLocalTranslationSingle(arg0);
+        break;
+
+    case IpiRemoteCall_InvalidateTranslationSingleASID:
+        invalidateLocalTranslationSingleASID(arg0, arg1);
+        break;
+
+    case IpiRemoteCall_InvalidateTranslationBatch:
+        invalidateLocalTranslationBatch((x86_tlb_shootdown_t *)arg0);
+        break;
+
+    case IpiRemoteCall_InvalidateTranslationAll:
+        invalidateLocalTranslationAll();
+        break;
+
+    case IpiRemoteCall_ReleaseFpuState:
+        handleRemoteFpuRelease((user_fpu_state_t *)arg0);
+        break;
 
 #ifdef CONFIG_VTX
-        case IpiRemoteCall_ClearCurrentVCPU:
-            clearCurrentVCPU();
-            break;
-        case IpiRemoteCall_VMCheckBoundNotification:
-            VMCheckBoundNotification((tcb_t *)arg0);
-            break;
+    case IpiRemoteCall_ClearCurrentVCPU:
+        clearCurrentVCPU();
+        break;
+    case IpiRemoteCall_VMCheckBoundNotification:
+        VMCheckBoundNotification((tcb_t *)arg0);
+        break;
 #endif
-        default:
-            Mode_handleRemoteCall(call, arg0, arg1, arg2);
-            break;
-        }
-
-        big_kernel_lock.node_owners[getCurrentCPUIndex()].ipi = 0;
-        ipi_wait(totalCoreBarrier);
+    default:
+        Mode_handleRemoteCall(call, arg0, arg1, arg2);
+        break;
     }
 }
 
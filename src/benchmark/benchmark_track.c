@@ -10,6 +10,7 @@
 
 #include <config.h>
 #include <benchmark/benchmark_track.h>
+#include <benchmark/benchmark_lock.h>
 #include <model/statedata.h>
 
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
@@ -28,7 +29,7 @@ void benchmark_track_exit(void)
         /* If Log buffer is filled, do nothing */
         if (likely(ksLogIndex < MAX_LOG_SIZE)) {
             duration = ksExit - ksEnter;
-            ksLog[ksLogIndex].entry = ksKernelEntry;
+            ksLog[ksLogIndex].entry = NODE_STATE(ksKernelEntry);
             ksLog[ksLogIndex].start_time = ksEnter;
             ksLog[ksLogIndex].duration = duration;
             ksLogIndex++;
@@ -36,3 +37,42 @@ void benchmark_track_exit(void)
     }
 }
 #endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES */
+
+#ifdef CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION
+
+seL4_Word ksLogIndex;
+seL4_Word ksLogIndexFinalized;
+
+static timestamp_t ksLockWaitStart[CONFIG_MAX_NUM_NODES];
+static timestamp_t ksLockAcquired[CONFIG_MAX_NUM_NODES];
+
+void benchmark_lock_wait(word_t cpu)
+{
+    ksLockWaitStart[cpu] = timestamp();
+}
+
+void benchmark_lock_acquired(word_t cpu)
+{
+    ksLockAcquired[cpu] = timestamp();
+}
+
+void benchmark_lock_release(word_t cpu)
+{
+    timestamp_t release = timestamp();
+    benchmark_track_lock_entry_t *ksLog = (benchmark_track_lock_entry_t *) KS_LOG_PPTR;
+
+    /* The lock is still held, so the log index is not contended. The entry
+     * record is this core's own, so no other core writes it meanwhile. */
+    if (likely(ksUserLogBuffer != 0)) {
+        /* If Log buffer is filled, do nothing */
+        if (likely(ksLogIndex < MAX_LOCK_LOG_SIZE)) {
+            ksLog[ksLogIndex].wait_start = ksLockWaitStart[cpu];
+            ksLog[ksLogIndex].wait = ksLockAcquired[cpu] - ksLockWaitStart[cpu];
+            ksLog[ksLogIndex].hold = release - ksLockAcquired[cpu];
+            ksLog[ksLogIndex].core = cpu;
+            ksLog[ksLogIndex].entry = NODE_STATE_ON_CORE(ksKernelEntry, cpu);
+            ksLogIndex++;
+        }
+    }
+}
+#endif /* CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION */
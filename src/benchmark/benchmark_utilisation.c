@@ -10,6 +10,7 @@
 
 #include <config.h>
 #include <benchmark/benchmark_utilisation.h>
+#include <benchmark/benchmark_lock.h>
 
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
 
@@ -52,6 +53,12 @@ void benchmark_track_utilisation_dump(void)
     buffer[BENCHMARK_TOTAL_UTILISATION] = benchmark_end_time - benchmark_start_time; /* Overall time */
 #endif /* CONFIG_ARM_ENABLE_PMU_OVERFLOW_INTERRUPT */
 
+#ifdef ENABLE_SMP_SUPPORT
+    buffer[BENCHMARK_RESCHEDULE_IPIS_SUPPRESSED] = ksRescheduleIPIsSuppressed;
+#else
+    buffer[BENCHMARK_RESCHEDULE_IPIS_SUPPRESSED] = 0;
+#endif
+
 }
 
 void benchmark_track_reset_utilisation(void)
@@ -74,4 +81,61 @@ void benchmark_track_reset_utilisation(void)
     tcb->benchmark.utilisation = 0;
     tcb->benchmark.schedule_start_time = 0;
 }
+
+compile_assert(core_utilisation_fits_ipc_buffer, BENCHMARK_CORES_PER_CALL >= 1)
+
+exception_t benchmark_track_core_utilisation_dump(void)
+{
+    seL4_IPCBuffer *ipcBuffer = (seL4_IPCBuffer *) lookupIPCBuffer(true, NODE_STATE(ksCurThread));
+    word_t first = getRegister(NODE_STATE(ksCurThread), capRegister);
+    word_t count = 0;
+
+    if (ipcBuffer == NULL) {
+        userError("SysBenchmarkGetCoreUtilisation: no IPC buffer");
+    } else if (first < ksNumCPUs) {
+        /* Write as many cores as fit in one go, so that on common core counts
+         * they are all read at the same point in time. Other cores may still
+         * be updating their own counters while we read them. */
+        count = MIN(ksNumCPUs - first, BENCHMARK_CORES_PER_CALL);
+        for (word_t n = 0; n < count; n++) {
+            for (word_t i = 0; i < BENCHMARK_CORE_NUM_COUNTERS; i++) {
+                uint64_t time = NODE_STATE_ON_CORE(ksCoreUtilisation, first + n).time[i];
+
+                for (word_t w = 0; w < BENCHMARK_CORE_COUNTER_WORDS; w++) {
+                    ipcBuffer->msg[BENCHMARK_CORE_UTILISATION_INDEX(n, i) + w] = (word_t)(time >> (w * wordBits));
+                }
+            }
+        }
+    }
+
+    setRegister(NODE_STATE(ksCurThread), capRegister, count);
+
+    return EXCEPTION_NONE;
+}
+
+void benchmark_track_reset_core_utilisation(void)
+{
+    for (word_t cpu = 0; cpu < ksNumCPUs; cpu++) {
+        for (word_t i = 0; i < BENCHMARK_CORE_NUM_COUNTERS; i++) {
+            NODE_STATE_ON_CORE(ksCoreUtilisation, cpu).time[i] = 0;
+        }
+    }
+}
+
+void benchmark_utilisation_lock_wait(word_t cpu)
+{
+    NODE_STATE_ON_CORE(ksCoreUtilisation, cpu).lock_wait_start = timestamp();
+}
+
+void benchmark_utilisation_lock_acquired(word_t cpu)
+{
+    benchmark_core_util_t *util = &NODE_STATE_ON_CORE(ksCoreUtilisation, cpu);
+    timestamp_t wait = timestamp() - util->lock_wait_start;
+
+    if (likely(benchmark_log_utilisation_enabled)) {
+        util->time[BENCHMARK_CORE_LOCK_WAIT] += wait;
+    }
+    /* Leave the wait out of whatever the core was doing before it */
+    util->period_start += wait;
+}
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
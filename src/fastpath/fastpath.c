@@ -15,6 +15,98 @@
 #include <benchmark/benchmark_track.h>
 #endif
 #include <benchmark/benchmark_utilisation.h>
+#ifdef CONFIG_TICKLESS
+#include <machine/timer.h>
+#endif
+
+#ifdef CONFIG_FASTPATH_CAP_TRANSFER
+/* A single cap transfer. It is checked before the fastpath's point of no
+ * return and performed after it. A NULL srcSlot means there is no cap, and a
+ * NULL destSlot means that only the badge of the cap is transferred. */
+typedef struct fastpath_cap_transfer {
+    cte_t *srcSlot;
+    cte_t *destSlot;
+    cap_t cap;
+    word_t *receiveBuffer;
+} fastpath_cap_transfer_t;
+
+/* Prepare the transfer of the extra cap of a message, if there is one.
+ * Returns false for anything transferCaps would not complete in full, in
+ * which case the caller takes the slowpath. */
+static inline bool_t FORCE_INLINE fastpath_prepare_cap_transfer(seL4_MessageInfo_t info, bool_t canGrant,
+                                                                tcb_t *sender, tcb_t *receiver,
+                                                                endpoint_t *ep_ptr,
+                                                                fastpath_cap_transfer_t *xfer)
+{
+    word_t *sendBuffer;
+    lookupSlot_raw_ret_t lu_ret;
+    deriveCap_ret_t dc_ret;
+
+    xfer->srcSlot = NULL;
+    if (likely(!seL4_MessageInfo_get_extraCaps(info))) {
+        return true;
+    }
+
+    /* Without grant rights the cap would be silently dropped */
+    if (unlikely(!canGrant)) {
+        return false;
+    }
+
+    sendBuffer = lookupIPCBuffer(false, sender);
+    xfer->receiveBuffer = lookupIPCBuffer(true, receiver);
+    if (unlikely(!sendBuffer || !xfer->receiveBuffer)) {
+        return false;
+    }
+
+    lu_ret = lookupSlot(sender, getExtraCPtr(sendBuffer, 0));
+    if (unlikely(lu_ret.status != EXCEPTION_NONE)) {
+        return false;
+    }
+    xfer->srcSlot = lu_ret.slot;
+    xfer->cap = lu_ret.slot->cap;
+
+    /* A cap to the endpoint the message is sent on is unwrapped */
+    if (cap_capType_equals(xfer->cap, cap_endpoint_cap) &&
+        EP_PTR(cap_endpoint_cap_get_capEPPtr(xfer->cap)) == ep_ptr) {
+        xfer->destSlot = NULL;
+        return true;
+    }
+
+    xfer->destSlot = getReceiveSlots(receiver, xfer->receiveBuffer);
+    if (unlikely(!xfer->destSlot)) {
+        return false;
+    }
+
+    dc_ret = deriveCap(xfer->srcSlot, xfer->cap);
+    if (unlikely(dc_ret.status != EXCEPTION_NONE ||
+                 cap_capType_equals(dc_ret.cap, cap_null_cap))) {
+        return false;
+    }
+    xfer->cap = dc_ret.cap;
+
+    return true;
+}
+
+/* Perform a transfer prepared by fastpath_prepare_cap_transfer and return
+ * the message info the receiver should see. */
+static inline seL4_MessageInfo_t FORCE_INLINE fastpath_do_cap_transfer(seL4_MessageInfo_t info,
+                                                                       fastpath_cap_transfer_t *xfer)
+{
+    info = seL4_MessageInfo_set_capsUnwrapped(info, 0);
+    if (likely(!xfer->srcSlot)) {
+        return info;
+    }
+
+    if (!xfer->destSlot) {
+        setExtraBadge(xfer->receiveBuffer, cap_endpoint_cap_get_capEPBadge(xfer->cap), 0);
+        info = seL4_MessageInfo_set_capsUnwrapped(info, 1);
+    } else {
+        cteInsert(xfer->cap, xfer->srcSlot, xfer->destSlot);
+    }
+
+    return seL4_MessageInfo_set_extraCaps(info, 1);
+}
+#endif /* CONFIG_FASTPATH_CAP_TRANSFER */
 
 void
 #ifdef ARCH_X86
@@ -35,6 +127,18 @@ fastpath_call(word_t cptr, word_t msgInfo)
     word_t fault_type;
     dom_t dom;
     word_t replyCanGrant;
+#ifdef CONFIG_FASTPATH_CAP_TRANSFER
+    fastpath_cap_transfer_t xfer;
+#endif
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    fastpath_buffers_t bufs;
+#endif
+
+#ifdef CONFIG_TICKLESS
+    if (unlikely(fastpath_ticks_pending())) {
+        slowpath(SysCall);
+    }
+#endif /* CONFIG_TICKLESS */
 
     /* Get message info, length, and fault type. */
     info = messageInfoFromWord_raw(msgInfo);
@@ -43,7 +147,7 @@ fastpath_call(word_t cptr, word_t msgInfo)
 
     /* Check there's no extra caps, the length is ok and there's no
      * saved fault. */
-    if (unlikely(fastpath_mi_check(msgInfo) ||
+    if (unlikely(fastpath_mi_check_caps(msgInfo) ||
                  fault_type != seL4_Fault_NullFault)) {
         slowpath(SysCall);
     }
@@ -59,6 +163,7 @@ fastpath_call(word_t cptr, word_t msgInfo)
 
     /* Get the endpoint address */
     ep_ptr = EP_PTR(cap_endpoint_cap_get_capEPPtr(ep_cap));
+    FASTPATH_LOCK_OBJECT(ep_ptr);
 
     /* Get the destination thread, which is only going to be valid
      * if the endpoint is valid. */
@@ -110,9 +215,23 @@ fastpath_call(word_t cptr, word_t msgInfo)
     dom = maxDom ? ksCurDomain : 0;
     /* ensure only the idle thread or lower prio threads are present in the scheduler */
     if (likely(dest->tcbPriority < NODE_STATE(ksCurThread->tcbPriority)) &&
-        !isHighestPrio(dom, dest->tcbPriority)) {
+        !fastpath_is_remote(dest) && !isHighestPrio(dom, dest->tcbPriority)) {
+        slowpath(SysCall);
+    }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    /* raising the priority of the server is left to the slowpath */
+    if (unlikely(inheritsPriorityFrom(dest, NODE_STATE(ksCurThread)))) {
+        slowpath(SysCall);
+    }
+#endif
+
+#ifdef CONFIG_THREAD_BUDGETS
+    /* a thread out of budget stays in the release queue until it is refilled */
+    if (unlikely(isThrottled(dest))) {
         slowpath(SysCall);
     }
+#endif
 
     /* Ensure that the endpoint has has grant or grant-reply rights so that we can
      * create the reply cap */
@@ -133,12 +252,29 @@ fastpath_call(word_t cptr, word_t msgInfo)
     }
 
 #ifdef ENABLE_SMP_SUPPORT
-    /* Ensure both threads have the same affinity */
-    if (unlikely(NODE_STATE(ksCurThread)->tcbAffinity != dest->tcbAffinity)) {
+    /* Ensure both threads have the same affinity, unless cross-core IPC
+     * is handled by the fastpath */
+    if (unlikely(NODE_STATE(ksCurThread)->tcbAffinity != dest->tcbAffinity &&
+                 !config_set(CONFIG_FASTPATH_CROSS_CORE))) {
         slowpath(SysCall);
     }
 #endif /* ENABLE_SMP_SUPPORT */
 
+#ifdef CONFIG_FASTPATH_CAP_TRANSFER
+    /* Check a single extra cap can be transferred in full */
+    if (unlikely(!fastpath_prepare_cap_transfer(info, cap_endpoint_cap_get_capCanGrant(ep_cap),
+                                                NODE_STATE(ksCurThread), dest, ep_ptr, &xfer))) {
+        slowpath(SysCall);
+    }
+#endif
+
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    /* Check a long message can be copied in full */
+    if (unlikely(!fastpath_lookup_buffers(length, NODE_STATE(ksCurThread), dest, &bufs))) {
+        slowpath(SysCall);
+    }
+#endif
+
     /*
      * --- POINT OF NO RETURN ---
      *
@@ -146,7 +282,7 @@ fastpath_call(word_t cptr, word_t msgInfo)
      */
 
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
-    ksKernelEntry.is_fastpath = true;
+    NODE_STATE(ksKernelEntry).is_fastpath = true;
 #endif
 
     /* Dequeue the destination. */
@@ -177,14 +313,31 @@ fastpath_call(word_t cptr, word_t msgInfo)
     mdb_node_ptr_mset_mdbNext_mdbRevocable_mdbFirstBadged(
         &replySlot->cteMDBNode, CTE_REF(callerSlot), 1, 1);
 
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    fastpath_copy_long_mrs(length, NODE_STATE(ksCurThread), dest, &bufs);
+#else
     fastpath_copy_mrs(length, NODE_STATE(ksCurThread), dest);
+#endif
 
     /* Dest thread is set Running, but not queued. */
     thread_state_ptr_set_tsType_np(&dest->tcbState,
                                    ThreadState_Running);
-    switchToThread_fp(dest, cap_pd, stored_hw_asid);
 
+#ifdef CONFIG_FASTPATH_CAP_TRANSFER
+    msgInfo = wordFromMessageInfo(fastpath_do_cap_transfer(info, &xfer));
+#else
     msgInfo = wordFromMessageInfo(seL4_MessageInfo_set_capsUnwrapped(info, 0));
+#endif
+
+#ifdef CONFIG_FASTPATH_CROSS_CORE
+    if (unlikely(fastpath_is_remote(dest))) {
+        fastpath_enqueue_remote(dest, badge, msgInfo);
+        fastpath_schedule_local();
+    }
+#endif /* CONFIG_FASTPATH_CROSS_CORE */
+
+    switchToThread_fp(dest, cap_pd, stored_hw_asid);
+    fastpath_set_timer_deadline();
 
     fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
 }
@@ -206,6 +359,15 @@ void fastpath_reply_recv(word_t cptr, word_t msgInfo)
     vspace_root_t *cap_pd;
     pde_t stored_hw_asid;
     dom_t dom;
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    fastpath_buffers_t bufs;
+#endif
+
+#ifdef CONFIG_TICKLESS
+    if (unlikely(fastpath_ticks_pending())) {
+        slowpath(SysReplyRecv);
+    }
+#endif /* CONFIG_TICKLESS */
 
     /* Get message info and length */
     info = messageInfoFromWord_raw(msgInfo);
@@ -214,7 +376,7 @@ void fastpath_reply_recv(word_t cptr, word_t msgInfo)
 
     /* Check there's no extra caps, the length is ok and there's no
      * saved fault. */
-    if (unlikely(fastpath_mi_check(msgInfo) ||
+    if (unlikely(fastpath_mi_check_length(msgInfo) ||
                  fault_type != seL4_Fault_NullFault)) {
         slowpath(SysReplyRecv);
     }
@@ -237,6 +399,7 @@ void fastpath_reply_recv(word_t cptr, word_t msgInfo)
 
     /* Get the endpoint address */
     ep_ptr = EP_PTR(cap_endpoint_cap_get_capEPPtr(ep_cap));
+    FASTPATH_LOCK_OBJECT(ep_ptr);
 
     /* Check that there's not a thread waiting to send */
     if (unlikely(endpoint_ptr_get_state(ep_ptr) == EPState_Send)) {
@@ -261,9 +424,11 @@ void fastpath_reply_recv(word_t cptr, word_t msgInfo)
 #endif
 
     /* Check that the caller has not faulted, in which case a fault
-       reply is generated instead. */
+       reply is generated instead. Replies to VM faults only restart the
+       caller, which can be done here. */
     fault_type = seL4_Fault_get_seL4_FaultType(caller->tcbFault);
-    if (unlikely(fault_type != seL4_Fault_NullFault)) {
+    if (unlikely(fault_type != seL4_Fault_NullFault &&
+                 !(config_set(CONFIG_VM_FAULT_FASTPATH) && fault_type == seL4_Fault_VMFault))) {
         slowpath(SysReplyRecv);
     }
 
@@ -297,9 +462,25 @@ void fastpath_reply_recv(word_t cptr, word_t msgInfo)
 
     /* Ensure the original caller can be scheduled directly. */
     dom = maxDom ? ksCurDomain : 0;
-    if (unlikely(!isHighestPrio(dom, caller->tcbPriority))) {
+    if (unlikely(!fastpath_is_remote(caller) && !isHighestPrio(dom, caller->tcbPriority))) {
+        slowpath(SysReplyRecv);
+    }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    /* restoring the priority of this or of the caller's server is left
+     * to the slowpath */
+    if (unlikely(hasInheritedPriority(NODE_STATE(ksCurThread)) ||
+                 caller->tcbInheritedBy != NULL)) {
+        slowpath(SysReplyRecv);
+    }
+#endif
+
+#ifdef CONFIG_THREAD_BUDGETS
+    /* a thread out of budget stays in the release queue until it is refilled */
+    if (unlikely(isThrottled(caller))) {
         slowpath(SysReplyRecv);
     }
+#endif
 
 #ifdef CONFIG_ARCH_AARCH32
     /* Ensure the HWASID is valid. */
@@ -314,12 +495,23 @@ void fastpath_reply_recv(word_t cptr, word_t msgInfo)
     }
 
 #ifdef ENABLE_SMP_SUPPORT
-    /* Ensure both threads have the same affinity */
-    if (unlikely(NODE_STATE(ksCurThread)->tcbAffinity != caller->tcbAffinity)) {
+    /* Ensure both threads have the same affinity, unless cross-core IPC
+     * is handled by the fastpath */
+    if (unlikely(NODE_STATE(ksCurThread)->tcbAffinity != caller->tcbAffinity &&
+                 !config_set(CONFIG_FASTPATH_CROSS_CORE))) {
         slowpath(SysReplyRecv);
     }
 #endif /* ENABLE_SMP_SUPPORT */
 
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    /* Check a long reply can be copied in full. A fault reply never
+     * copies the message. */
+    if (unlikely(fault_type == seL4_Fault_NullFault &&
+                 !fastpath_lookup_buffers(length, NODE_STATE(ksCurThread), caller, &bufs))) {
+        slowpath(SysReplyRecv);
+    }
+#endif
+
     /*
      * --- POINT OF NO RETURN ---
      *
@@ -327,7 +519,7 @@ void fastpath_reply_recv(word_t cptr, word_t msgInfo)
      */
 
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
-    ksKernelEntry.is_fastpath = true;
+    NODE_STATE(ksKernelEntry).is_fastpath = true;
 #endif
 
     /* Set thread state to BlockedOnReceive */
@@ -364,19 +556,923 @@ void fastpath_reply_recv(word_t cptr, word_t msgInfo)
     callerSlot->cap = cap_null_cap_new();
     callerSlot->cteMDBNode = nullMDBNode;
 
+#ifdef CONFIG_VM_FAULT_FASTPATH
+    if (unlikely(fault_type == seL4_Fault_VMFault)) {
+        /* The reply carries no message, the caller simply restarts the
+         * faulting instruction. */
+        caller->tcbFault = seL4_Fault_NullFault_new();
+
+#ifdef CONFIG_FASTPATH_CROSS_CORE
+        if (unlikely(fastpath_is_remote(caller))) {
+            thread_state_ptr_set_tsType_np(&caller->tcbState, ThreadState_Restart);
+            SCHED_ENQUEUE(caller);
+            fastpath_schedule_local();
+        }
+#endif /* CONFIG_FASTPATH_CROSS_CORE */
+
+        setNextPC(caller, getRestartPC(caller));
+        thread_state_ptr_set_tsType_np(&caller->tcbState, ThreadState_Running);
+
+        switchToThread_fp(caller, cap_pd, stored_hw_asid);
+        fastpath_set_timer_deadline();
+
+        /* The caller entered the kernel through an exception, so all of
+         * its registers must be restored. */
+        restore_user_context();
+        UNREACHABLE();
+    }
+#endif /* CONFIG_VM_FAULT_FASTPATH */
+
     /* I know there's no fault, so straight to the transfer. */
 
     /* Replies don't have a badge. */
     badge = 0;
 
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    fastpath_copy_long_mrs(length, NODE_STATE(ksCurThread), caller, &bufs);
+#else
     fastpath_copy_mrs(length, NODE_STATE(ksCurThread), caller);
+#endif
 
     /* Dest thread is set Running, but not queued. */
     thread_state_ptr_set_tsType_np(&caller->tcbState,
                                    ThreadState_Running);
+
+    msgInfo = wordFromMessageInfo(seL4_MessageInfo_set_capsUnwrapped(info, 0));
+
+#ifdef CONFIG_FASTPATH_CROSS_CORE
+    if (unlikely(fastpath_is_remote(caller))) {
+        fastpath_enqueue_remote(caller, badge, msgInfo);
+        fastpath_schedule_local();
+    }
+#endif /* CONFIG_FASTPATH_CROSS_CORE */
+
     switchToThread_fp(caller, cap_pd, stored_hw_asid);
+    fastpath_set_timer_deadline();
+
+    fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
+}
+
+#ifdef CONFIG_VM_FAULT_FASTPATH
+static void NORETURN vm_fault_slowpath(vm_fault_type_t type)
+{
+    /* drop the object lock taken by the fastpath and make sure the big
+     * kernel lock is held before handling the fault in full */
+    FASTPATH_UNLOCK_OBJECT;
+    NODE_LOCK_SLOWPATH;
+
+#ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
+    NODE_STATE(ksKernelEntry).is_fastpath = false;
+#endif
+    handleVMFaultEvent(type);
+    restore_user_context();
+    UNREACHABLE();
+}
+
+void fastpath_vm_fault(vm_fault_type_t type)
+{
+    cap_t ep_cap;
+    endpoint_t *ep_ptr;
+    tcb_t *dest;
+    word_t badge;
+    word_t length;
+    word_t msgInfo;
+    word_t *receiveBuffer;
+    cte_t *replySlot, *callerSlot;
+    cap_t newVTable;
+    vspace_root_t *cap_pd;
+    pde_t stored_hw_asid;
+    dom_t dom;
+    word_t replyCanGrant;
+
+#ifdef CONFIG_TICKLESS
+    if (unlikely(fastpath_ticks_pending())) {
+        vm_fault_slowpath(type);
+    }
+#endif /* CONFIG_TICKLESS */
+
+    /* Record the fault in current_fault */
+    if (unlikely(handleVMFault(NODE_STATE(ksCurThread), type) != EXCEPTION_FAULT)) {
+        vm_fault_slowpath(type);
+    }
+
+    /* Lookup the fault handler cap. A failed lookup returns a null cap,
+     * the resulting cap fault is left to the slowpath. */
+    ep_cap = lookup_fp(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbCTable)->cap,
+                       NODE_STATE(ksCurThread)->tcbFaultHandler);
+
+    /* Check it's an endpoint that a fault can be sent on */
+    if (unlikely(!cap_capType_equals(ep_cap, cap_endpoint_cap) ||
+                 !cap_endpoint_cap_get_capCanSend(ep_cap))) {
+        vm_fault_slowpath(type);
+    }
+
+    /* Ensure that the endpoint has has grant or grant-reply rights so that we can
+     * create the reply cap */
+    if (unlikely(!cap_endpoint_cap_get_capCanGrant(ep_cap) &&
+                 !cap_endpoint_cap_get_capCanGrantReply(ep_cap))) {
+        vm_fault_slowpath(type);
+    }
+
+    /* Get the endpoint address */
+    ep_ptr = EP_PTR(cap_endpoint_cap_get_capEPPtr(ep_cap));
+    FASTPATH_LOCK_OBJECT(ep_ptr);
+
+    /* Get the destination thread, which is only going to be valid
+     * if the endpoint is valid. */
+    dest = TCB_PTR(endpoint_ptr_get_epQueue_head(ep_ptr));
+
+    /* Check that there's a thread waiting to receive */
+    if (unlikely(endpoint_ptr_get_state(ep_ptr) != EPState_Recv)) {
+        vm_fault_slowpath(type);
+    }
+
+    /* ensure we are not single stepping the destination in ia32 */
+#if defined(CONFIG_HARDWARE_DEBUG_API) && defined(CONFIG_ARCH_IA32)
+    if (dest->tcbArch.tcbContext.breakpointState.single_step_enabled) {
+        vm_fault_slowpath(type);
+    }
+#endif
+
+    /* Get destination thread.*/
+    newVTable = TCB_PTR_CTE_PTR(dest, tcbVTable)->cap;
+
+    /* Get vspace root. */
+    cap_pd = cap_vtable_cap_get_vspace_root_fp(newVTable);
+
+    /* Ensure that the destination has a valid VTable. */
+    if (unlikely(! isValidVTableRoot_fp(newVTable))) {
+        vm_fault_slowpath(type);
+    }
+
+#ifdef CONFIG_ARCH_AARCH32
+    /* Get HW ASID */
+    stored_hw_asid = cap_pd[PD_ASID_SLOT];
+#endif
+
+#ifdef CONFIG_ARCH_X86_64
+    /* borrow the stored_hw_asid for PCID */
+    stored_hw_asid.words[0] = cap_pml4_cap_get_capPML4MappedASID_fp(newVTable);
+#endif
+
+#ifdef CONFIG_ARCH_AARCH64
+    stored_hw_asid.words[0] = cap_page_global_directory_cap_get_capPGDMappedASID(newVTable);
+#endif
+
+#ifdef CONFIG_ARCH_RISCV
+    /* Get HW ASID */
+    stored_hw_asid.words[0] = cap_page_table_cap_get_capPTMappedASID(newVTable);
+#endif
+
+    /* let gcc optimise this out for 1 domain */
+    dom = maxDom ? ksCurDomain : 0;
+    /* ensure only the idle thread or lower prio threads are present in the scheduler */
+    if (likely(dest->tcbPriority < NODE_STATE(ksCurThread->tcbPriority)) &&
+        !fastpath_is_remote(dest) && !isHighestPrio(dom, dest->tcbPriority)) {
+        vm_fault_slowpath(type);
+    }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    /* raising the priority of the fault handler is left to the slowpath */
+    if (unlikely(inheritsPriorityFrom(dest, NODE_STATE(ksCurThread)))) {
+        vm_fault_slowpath(type);
+    }
+#endif
+
+#ifdef CONFIG_THREAD_BUDGETS
+    if (unlikely(isThrottled(dest))) {
+        vm_fault_slowpath(type);
+    }
+#endif
+
+#ifdef CONFIG_ARCH_AARCH32
+    if (unlikely(!pde_pde_invalid_get_stored_asid_valid(stored_hw_asid))) {
+        vm_fault_slowpath(type);
+    }
+#endif
+
+    /* Ensure the fault handler is in the current domain and can be scheduled directly. */
+    if (unlikely(dest->tcbDomain != ksCurDomain && maxDom)) {
+        vm_fault_slowpath(type);
+    }
+
+#ifdef ENABLE_SMP_SUPPORT
+    /* Ensure both threads have the same affinity, unless cross-core IPC
+     * is handled by the fastpath */
+    if (unlikely(NODE_STATE(ksCurThread)->tcbAffinity != dest->tcbAffinity &&
+                 !config_set(CONFIG_FASTPATH_CROSS_CORE))) {
+        vm_fault_slowpath(type);
+    }
+#endif /* ENABLE_SMP_SUPPORT */
+
+    /*
+     * --- POINT OF NO RETURN ---
+     *
+     * At this stage, we have committed to delivering the fault.
+     */
+
+#ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
+    NODE_STATE(ksKernelEntry).is_fastpath = true;
+#endif
+
+    NODE_STATE(ksCurThread)->tcbFault = current_fault;
+
+    /* Dequeue the destination. */
+    endpoint_ptr_set_epQueue_head_np(ep_ptr, TCB_REF(dest->tcbEPNext));
+    if (unlikely(dest->tcbEPNext)) {
+        dest->tcbEPNext->tcbEPPrev = NULL;
+    } else {
+        endpoint_ptr_mset_epQueue_tail_state(ep_ptr, 0, EPState_Idle);
+    }
+
+    badge = cap_endpoint_cap_get_capEPBadge(ep_cap);
+
+    /* Block the faulting thread */
+    thread_state_ptr_set_tsType_np(&NODE_STATE(ksCurThread)->tcbState,
+                                   ThreadState_BlockedOnReply);
+
+    /* Get faulting thread reply slot */
+    replySlot = TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbReply);
+
+    /* Get dest caller slot */
+    callerSlot = TCB_PTR_CTE_PTR(dest, tcbCaller);
+
+    /* Insert reply cap */
+    replyCanGrant = thread_state_ptr_get_blockingIPCCanGrant(&dest->tcbState);
+    cap_reply_cap_ptr_new_np(&callerSlot->cap, replyCanGrant, 0,
+                             TCB_REF(NODE_STATE(ksCurThread)));
+    mdb_node_ptr_set_mdbPrev_np(&callerSlot->cteMDBNode, CTE_REF(replySlot));
+    mdb_node_ptr_mset_mdbNext_mdbRevocable_mdbFirstBadged(
+        &replySlot->cteMDBNode, CTE_REF(callerSlot), 1, 1);
+
+    /* The IPC buffer is only needed where the fault message does not fit
+     * in the message registers, which is known at compile time. */
+    if ((word_t)seL4_VMFault_Length > (word_t)n_msgRegisters) {
+        receiveBuffer = lookupIPCBuffer(true, dest);
+    } else {
+        receiveBuffer = NULL;
+    }
+    length = setMRs_fault(NODE_STATE(ksCurThread), dest, receiveBuffer);
+
+    /* Dest thread is set Running, but not queued. */
+    thread_state_ptr_set_tsType_np(&dest->tcbState,
+                                   ThreadState_Running);
+
+    msgInfo = wordFromMessageInfo(seL4_MessageInfo_new(seL4_Fault_VMFault, 0, 0, length));
+
+#ifdef CONFIG_FASTPATH_CROSS_CORE
+    if (unlikely(fastpath_is_remote(dest))) {
+        fastpath_enqueue_remote(dest, badge, msgInfo);
+        fastpath_schedule_local();
+    }
+#endif /* CONFIG_FASTPATH_CROSS_CORE */
+
+    switchToThread_fp(dest, cap_pd, stored_hw_asid);
+    fastpath_set_timer_deadline();
+
+    fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
+}
+#endif /* CONFIG_VM_FAULT_FASTPATH */
+
+#if defined(CONFIG_SEND_FASTPATH) || defined(CONFIG_SIGNAL_FASTPATH)
+#ifdef CONFIG_SEND_FASTPATH
+static inline void NORETURN FORCE_INLINE fastpath_send_ep(word_t cptr, word_t msgInfo, cap_t ep_cap,
+                                                          syscall_t syscall)
+{
+    seL4_MessageInfo_t info;
+    endpoint_t *ep_ptr;
+    word_t length;
+    tcb_t *dest;
+    word_t badge;
+    cap_t newVTable;
+    vspace_root_t *cap_pd;
+    pde_t stored_hw_asid;
+#ifdef CONFIG_FASTPATH_CAP_TRANSFER
+    fastpath_cap_transfer_t xfer;
+#endif
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    fastpath_buffers_t bufs;
+#endif
+
+    /* Get message info and length. */
+    info = messageInfoFromWord_raw(msgInfo);
+    length = seL4_MessageInfo_get_length(info);
+
+    /* Check we can send on the endpoint */
+    if (unlikely(!cap_endpoint_cap_get_capCanSend(ep_cap))) {
+        slowpath(syscall);
+    }
+
+    /* Get the endpoint address */
+    ep_ptr = EP_PTR(cap_endpoint_cap_get_capEPPtr(ep_cap));
+    FASTPATH_LOCK_OBJECT(ep_ptr);
+
+    /* Get the destination thread, which is only going to be valid
+     * if the endpoint is valid. */
+    dest = TCB_PTR(endpoint_ptr_get_epQueue_head(ep_ptr));
+
+    /* Check that there's a thread waiting to receive. Blocking and
+     * non-blocking sends behave identically in this case. */
+    if (unlikely(endpoint_ptr_get_state(ep_ptr) != EPState_Recv)) {
+        slowpath(syscall);
+    }
+
+    /* ensure we are not single stepping the destination in ia32 */
+#if defined(CONFIG_HARDWARE_DEBUG_API) && defined(CONFIG_ARCH_IA32)
+    if (dest->tcbArch.tcbContext.breakpointState.single_step_enabled) {
+        slowpath(syscall);
+    }
+#endif
+
+    /* Get destination thread.*/
+    newVTable = TCB_PTR_CTE_PTR(dest, tcbVTable)->cap;
+
+    /* Get vspace root. */
+    cap_pd = cap_vtable_cap_get_vspace_root_fp(newVTable);
+
+    /* Ensure that the destination has a valid VTable. */
+    if (unlikely(! isValidVTableRoot_fp(newVTable))) {
+        slowpath(syscall);
+    }
+
+#ifdef CONFIG_ARCH_AARCH32
+    /* Get HW ASID */
+    stored_hw_asid = cap_pd[PD_ASID_SLOT];
+#endif
+
+#ifdef CONFIG_ARCH_X86_64
+    /* borrow the stored_hw_asid for PCID */
+    stored_hw_asid.words[0] = cap_pml4_cap_get_capPML4MappedASID_fp(newVTable);
+#endif
+
+#ifdef CONFIG_ARCH_AARCH64
+    stored_hw_asid.words[0] = cap_page_global_directory_cap_get_capPGDMappedASID(newVTable);
+#endif
+
+#ifdef CONFIG_ARCH_RISCV
+    /* Get HW ASID */
+    stored_hw_asid.words[0] = cap_page_table_cap_get_capPTMappedASID(newVTable);
+#endif
+
+#ifdef CONFIG_ARCH_AARCH32
+    if (unlikely(!pde_pde_invalid_get_stored_asid_valid(stored_hw_asid))) {
+        slowpath(syscall);
+    }
+#endif
+
+    /* Ensure the receiver is in the current domain so it can either be
+     * scheduled directly or placed in the current domain's ready queues. */
+    if (unlikely(dest->tcbDomain != ksCurDomain && maxDom)) {
+        slowpath(syscall);
+    }
+
+#ifdef CONFIG_THREAD_BUDGETS
+    /* a thread out of budget stays in the release queue until it is refilled */
+    if (unlikely(isThrottled(dest))) {
+        slowpath(syscall);
+    }
+#endif
+
+#ifdef ENABLE_SMP_SUPPORT
+    /* Ensure both threads have the same affinity, unless cross-core IPC
+     * is handled by the fastpath */
+    if (unlikely(NODE_STATE(ksCurThread)->tcbAffinity != dest->tcbAffinity &&
+                 !config_set(CONFIG_FASTPATH_CROSS_CORE))) {
+        slowpath(syscall);
+    }
+#endif /* ENABLE_SMP_SUPPORT */
+
+#ifdef CONFIG_FASTPATH_CAP_TRANSFER
+    /* Check a single extra cap can be transferred in full */
+    if (unlikely(!fastpath_prepare_cap_transfer(info, cap_endpoint_cap_get_capCanGrant(ep_cap),
+                                                NODE_STATE(ksCurThread), dest, ep_ptr, &xfer))) {
+        slowpath(syscall);
+    }
+#endif
+
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    /* Check a long message can be copied in full */
+    if (unlikely(!fastpath_lookup_buffers(length, NODE_STATE(ksCurThread), dest, &bufs))) {
+        slowpath(syscall);
+    }
+#endif
+
+    /*
+     * --- POINT OF NO RETURN ---
+     *
+     * At this stage, we have committed to performing the IPC.
+     */
+
+#ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
+    NODE_STATE(ksKernelEntry).is_fastpath = true;
+#endif
+
+    /* Dequeue the destination. */
+    endpoint_ptr_set_epQueue_head_np(ep_ptr, TCB_REF(dest->tcbEPNext));
+    if (unlikely(dest->tcbEPNext)) {
+        dest->tcbEPNext->tcbEPPrev = NULL;
+    } else {
+        endpoint_ptr_mset_epQueue_tail_state(ep_ptr, 0, EPState_Idle);
+    }
+
+    badge = cap_endpoint_cap_get_capEPBadge(ep_cap);
+
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    fastpath_copy_long_mrs(length, NODE_STATE(ksCurThread), dest, &bufs);
+#else
+    fastpath_copy_mrs(length, NODE_STATE(ksCurThread), dest);
+#endif
+
+    /* Dest thread is set Running. No reply cap is created and the
+     * sender remains Running. */
+    thread_state_ptr_set_tsType_np(&dest->tcbState,
+                                   ThreadState_Running);
+
+#ifdef CONFIG_FASTPATH_CAP_TRANSFER
+    info = fastpath_do_cap_transfer(info, &xfer);
+#else
+    info = seL4_MessageInfo_set_capsUnwrapped(info, 0);
+#endif
+
+#ifdef CONFIG_FASTPATH_CROSS_CORE
+    if (unlikely(fastpath_is_remote(dest))) {
+        /* The sender stays on the short path and the receiver's core is
+         * sent at most one reschedule IPI. */
+        fastpath_enqueue_remote(dest, badge, wordFromMessageInfo(info));
+        fastpath_flush_reschedule();
+        fastpath_restore(cptr, msgInfo, NODE_STATE(ksCurThread));
+    }
+#endif /* CONFIG_FASTPATH_CROSS_CORE */
+
+    if (likely(dest->tcbPriority > NODE_STATE(ksCurThread)->tcbPriority)) {
+        /* The receiver preempts the sender. As in schedule(), the sender
+         * goes back to the head of its ready queue. */
+        SCHED_ENQUEUE_CURRENT_TCB;
+        switchToThread_fp(dest, cap_pd, stored_hw_asid);
+        fastpath_set_timer_deadline();
+        fastpath_restore(badge, wordFromMessageInfo(info), NODE_STATE(ksCurThread));
+    }
+
+    /* The sender keeps running, so the message is delivered into the
+     * receiver's saved context and the receiver is queued the same way
+     * schedule() would have queued a rejected switch candidate. */
+    setRegister(dest, badgeRegister, badge);
+    setRegister(dest, msgInfoRegister, wordFromMessageInfo(info));
+    if (dest->tcbPriority == NODE_STATE(ksCurThread)->tcbPriority) {
+        tcbSchedAppend(dest);
+    } else {
+        tcbSchedEnqueue(dest);
+    }
+
+    /* Return to the sender with its capRegister and msgInfoRegister intact. */
+    fastpath_restore(cptr, msgInfo, NODE_STATE(ksCurThread));
+}
+#endif /* CONFIG_SEND_FASTPATH */
+
+#ifdef CONFIG_SIGNAL_FASTPATH
+static inline void NORETURN FORCE_INLINE fastpath_signal(word_t cptr, word_t msgInfo, cap_t ntfn_cap,
+                                                         syscall_t syscall)
+{
+    notification_t *ntfn_ptr;
+    word_t badge;
+    tcb_t *dest;
+    cap_t newVTable;
+    vspace_root_t *cap_pd;
+    pde_t stored_hw_asid;
+
+    /* Check we can signal the notification. Extra caps are looked up
+     * before signalling, which is left to the slowpath. */
+    if (unlikely(!cap_notification_cap_get_capNtfnCanSend(ntfn_cap) ||
+                 seL4_MessageInfo_get_extraCaps(messageInfoFromWord_raw(msgInfo)))) {
+        slowpath(syscall);
+    }
+
+    ntfn_ptr = NTFN_PTR(cap_notification_cap_get_capNtfnPtr(ntfn_cap));
+    badge = cap_notification_cap_get_capNtfnBadge(ntfn_cap);
+    FASTPATH_LOCK_OBJECT(ntfn_ptr);
+
+    switch (notification_ptr_get_state(ntfn_ptr)) {
+    case NtfnState_Active:
+#ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
+        NODE_STATE(ksKernelEntry).is_fastpath = true;
+#endif
+        /* Accumulate the badge and return straight to the sender. */
+        notification_ptr_set_ntfnMsgIdentifier(ntfn_ptr,
+                                               notification_ptr_get_ntfnMsgIdentifier(ntfn_ptr) | badge);
+        fastpath_restore(cptr, msgInfo, NODE_STATE(ksCurThread));
+
+    case NtfnState_Idle:
+        dest = TCB_PTR(notification_ptr_get_ntfnBoundTCB(ntfn_ptr));
+#ifdef CONFIG_FASTPATH_FINE_GRAINED_LOCKING
+        /* The receive fastpaths check the bound notification before blocking
+         * on an endpoint without holding its lock, so a bound thread can only
+         * be signalled with the big kernel lock held. */
+        if (unlikely(dest)) {
+            slowpath(syscall);
+        }
+#endif
+        /* A bound thread that is waiting for a message has to be pulled out
+         * of its endpoint queue, which is left to the slowpath. */
+        if (dest) {
+            word_t tsType = thread_state_ptr_get_tsType(&dest->tcbState);
+            if (unlikely(tsType == ThreadState_BlockedOnReceive
+#ifdef CONFIG_VTX
+                         || tsType == ThreadState_RunningVM
+#endif
+                        )) {
+                slowpath(syscall);
+            }
+        }
+#ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
+        NODE_STATE(ksKernelEntry).is_fastpath = true;
+#endif
+        notification_ptr_set_state(ntfn_ptr, NtfnState_Active);
+        notification_ptr_set_ntfnMsgIdentifier(ntfn_ptr, badge);
+        fastpath_restore(cptr, msgInfo, NODE_STATE(ksCurThread));
+
+    default:
+        break;
+    }
+
+    /* NtfnState_Waiting: wake up the head of the queue. */
+    dest = TCB_PTR(notification_ptr_get_ntfnQueue_head(ntfn_ptr));
+
+    /* ensure we are not single stepping the destination in ia32 */
+#if defined(CONFIG_HARDWARE_DEBUG_API) && defined(CONFIG_ARCH_IA32)
+    if (dest->tcbArch.tcbContext.breakpointState.single_step_enabled) {
+        slowpath(syscall);
+    }
+#endif
+
+    /* Get destination thread.*/
+    newVTable = TCB_PTR_CTE_PTR(dest, tcbVTable)->cap;
+
+    /* Get vspace root. */
+    cap_pd = cap_vtable_cap_get_vspace_root_fp(newVTable);
+
+    /* Ensure that the destination has a valid VTable. */
+    if (unlikely(! isValidVTableRoot_fp(newVTable))) {
+        slowpath(syscall);
+    }
+
+#ifdef CONFIG_ARCH_AARCH32
+    /* Get HW ASID */
+    stored_hw_asid = cap_pd[PD_ASID_SLOT];
+#endif
+
+#ifdef CONFIG_ARCH_X86_64
+    /* borrow the stored_hw_asid for PCID */
+    stored_hw_asid.words[0] = cap_pml4_cap_get_capPML4MappedASID_fp(newVTable);
+#endif
+
+#ifdef CONFIG_ARCH_AARCH64
+    stored_hw_asid.words[0] = cap_page_global_directory_cap_get_capPGDMappedASID(newVTable);
+#endif
+
+#ifdef CONFIG_ARCH_RISCV
+    /* Get HW ASID */
+    stored_hw_asid.words[0] = cap_page_table_cap_get_capPTMappedASID(newVTable);
+#endif
+
+#ifdef CONFIG_ARCH_AARCH32
+    if (unlikely(!pde_pde_invalid_get_stored_asid_valid(stored_hw_asid))) {
+        slowpath(syscall);
+    }
+#endif
+
+    /* Ensure the waiter is in the current domain. */
+    if (unlikely(dest->tcbDomain != ksCurDomain && maxDom)) {
+        slowpath(syscall);
+    }
+
+#ifdef CONFIG_THREAD_BUDGETS
+    /* a thread out of budget stays in the release queue until it is refilled */
+    if (unlikely(isThrottled(dest))) {
+        slowpath(syscall);
+    }
+#endif
+
+#ifdef ENABLE_SMP_SUPPORT
+    /* Ensure both threads have the same affinity, unless cross-core IPC
+     * is handled by the fastpath */
+    if (unlikely(NODE_STATE(ksCurThread)->tcbAffinity != dest->tcbAffinity &&
+                 !config_set(CONFIG_FASTPATH_CROSS_CORE))) {
+        slowpath(syscall);
+    }
+#endif /* ENABLE_SMP_SUPPORT */
+
+    /*
+     * --- POINT OF NO RETURN ---
+     *
+     * At this stage, we have committed to delivering the signal.
+     */
+
+#ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
+    NODE_STATE(ksKernelEntry).is_fastpath = true;
+#endif
+
+    /* Dequeue the waiter. */
+    notification_ptr_set_ntfnQueue_head(ntfn_ptr, TCB_REF(dest->tcbEPNext));
+    if (unlikely(dest->tcbEPNext)) {
+        dest->tcbEPNext->tcbEPPrev = NULL;
+    } else {
+        notification_ptr_set_ntfnQueue_tail(ntfn_ptr, 0);
+        notification_ptr_set_state(ntfn_ptr, NtfnState_Idle);
+    }
+
+    thread_state_ptr_set_tsType_np(&dest->tcbState,
+                                   ThreadState_Running);
+
+#ifdef CONFIG_FASTPATH_CROSS_CORE
+    if (unlikely(fastpath_is_remote(dest))) {
+        fastpath_enqueue_remote(dest, badge, getRegister(dest, msgInfoRegister));
+        fastpath_flush_reschedule();
+        fastpath_restore(cptr, msgInfo, NODE_STATE(ksCurThread));
+    }
+#endif /* CONFIG_FASTPATH_CROSS_CORE */
+
+    if (likely(dest->tcbPriority > NODE_STATE(ksCurThread)->tcbPriority)) {
+        /* The waiter preempts the signaller, which goes back to the head
+         * of its ready queue as it would in schedule(). Only the badge
+         * register of the waiter changes. */
+        SCHED_ENQUEUE_CURRENT_TCB;
+        msgInfo = getRegister(dest, msgInfoRegister);
+        switchToThread_fp(dest, cap_pd, stored_hw_asid);
+        fastpath_set_timer_deadline();
+        fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
+    }
+
+    setRegister(dest, badgeRegister, badge);
+    if (dest->tcbPriority == NODE_STATE(ksCurThread)->tcbPriority) {
+        tcbSchedAppend(dest);
+    } else {
+        tcbSchedEnqueue(dest);
+    }
+
+    fastpath_restore(cptr, msgInfo, NODE_STATE(ksCurThread));
+}
+#endif /* CONFIG_SIGNAL_FASTPATH */
+
+/* Fastpath for SysSend and SysNBSend. Depending on the configuration this
+ * handles sends to an endpoint with a waiting receiver and signals on a
+ * notification. Everything else is handed to the slowpath. */
+void
+#ifdef ARCH_X86
+NORETURN
+#endif
+fastpath_send(word_t cptr, word_t msgInfo, syscall_t syscall)
+{
+    cap_t cap;
+    word_t fault_type;
+
+#ifdef CONFIG_TICKLESS
+    if (unlikely(fastpath_ticks_pending())) {
+        slowpath(syscall);
+    }
+#endif /* CONFIG_TICKLESS */
+
+    fault_type = seL4_Fault_get_seL4_FaultType(NODE_STATE(ksCurThread)->tcbFault);
+
+    /* Check there's at most one extra cap, the length is ok and there's
+     * no saved fault. */
+    if (unlikely(fastpath_mi_check_caps(msgInfo) ||
+                 fault_type != seL4_Fault_NullFault)) {
+        slowpath(syscall);
+    }
+
+    /* Lookup the cap */
+    cap = lookup_fp(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbCTable)->cap, cptr);
+
+#ifdef CONFIG_SEND_FASTPATH
+    if (cap_capType_equals(cap, cap_endpoint_cap)) {
+        fastpath_send_ep(cptr, msgInfo, cap, syscall);
+    }
+#endif /* CONFIG_SEND_FASTPATH */
+
+#ifdef CONFIG_SIGNAL_FASTPATH
+    if (cap_capType_equals(cap, cap_notification_cap)) {
+        fastpath_signal(cptr, msgInfo, cap, syscall);
+    }
+#endif /* CONFIG_SIGNAL_FASTPATH */
+
+    slowpath(syscall);
+}
+#endif /* CONFIG_SEND_FASTPATH || CONFIG_SIGNAL_FASTPATH */
+
+#ifdef CONFIG_RECV_FASTPATH
+/* Fastpath for SysRecv and SysNBRecv when the receive can complete
+ * immediately, i.e. a signal is pending on the notification, or a sender
+ * with a short message and no caps is queued on the endpoint. The current
+ * thread keeps running in all cases handled here. */
+void
+#ifdef ARCH_X86
+NORETURN
+#endif
+fastpath_recv(word_t cptr, word_t msgInfo, syscall_t syscall)
+{
+    seL4_MessageInfo_t info;
+    cap_t cap;
+    notification_t *ntfn_ptr;
+    endpoint_t *ep_ptr;
+    tcb_t *sender, *boundTCB;
+    cte_t *replySlot, *callerSlot;
+    word_t senderInfo;
+    word_t length;
+    word_t badge;
+    word_t fault_type;
+    bool_t do_call;
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    fastpath_buffers_t bufs;
+#endif
+
+    /* Lookup the cap */
+    cap = lookup_fp(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbCTable)->cap, cptr);
+
+    if (cap_capType_equals(cap, cap_notification_cap)) {
+        ntfn_ptr = NTFN_PTR(cap_notification_cap_get_capNtfnPtr(cap));
+        FASTPATH_LOCK_OBJECT(ntfn_ptr);
+
+        /* Check we can receive, that the notification is not bound to some
+         * other thread and that there is a signal to collect. */
+        if (unlikely(!cap_notification_cap_get_capNtfnCanReceive(cap) ||
+                     notification_ptr_get_state(ntfn_ptr) != NtfnState_Active)) {
+            slowpath(syscall);
+        }
+        boundTCB = TCB_PTR(notification_ptr_get_ntfnBoundTCB(ntfn_ptr));
+        if (unlikely(boundTCB && boundTCB != NODE_STATE(ksCurThread))) {
+            slowpath(syscall);
+        }
+
+#ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
+        NODE_STATE(ksKernelEntry).is_fastpath = true;
+#endif
+        badge = notification_ptr_get_ntfnMsgIdentifier(ntfn_ptr);
+        notification_ptr_set_state(ntfn_ptr, NtfnState_Idle);
+        fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
+    }
+
+    /* Check it's an endpoint */
+    if (unlikely(!cap_capType_equals(cap, cap_endpoint_cap) ||
+                 !cap_endpoint_cap_get_capCanReceive(cap))) {
+        slowpath(syscall);
+    }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    /* Receiving on an endpoint restores the priority of a server, which
+     * is left to the slowpath. */
+    if (unlikely(hasInheritedPriority(NODE_STATE(ksCurThread)))) {
+        slowpath(syscall);
+    }
+#endif
+
+    /* Receiving on an endpoint deletes any reply cap left in the caller
+     * slot, which is left to the slowpath. */
+    callerSlot = TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbCaller);
+    if (unlikely(!cap_capType_equals(callerSlot->cap, cap_null_cap))) {
+        slowpath(syscall);
+    }
+
+    /* A pending signal on the bound notification takes precedence over
+     * the endpoint. */
+    ntfn_ptr = NODE_STATE(ksCurThread)->tcbBoundNotification;
+    if (ntfn_ptr) {
+        FASTPATH_LOCK_OBJECT(ntfn_ptr);
+        if (notification_ptr_get_state(ntfn_ptr) == NtfnState_Active) {
+#ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
+            NODE_STATE(ksKernelEntry).is_fastpath = true;
+#endif
+            badge = notification_ptr_get_ntfnMsgIdentifier(ntfn_ptr);
+            notification_ptr_set_state(ntfn_ptr, NtfnState_Idle);
+            fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
+        }
+        FASTPATH_UNLOCK_OBJECT;
+    }
+
+    /* Get the endpoint address */
+    ep_ptr = EP_PTR(cap_endpoint_cap_get_capEPPtr(cap));
+    FASTPATH_LOCK_OBJECT(ep_ptr);
+
+    /* Check that there's a thread waiting to send */
+    if (unlikely(endpoint_ptr_get_state(ep_ptr) != EPState_Send)) {
+        slowpath(syscall);
+    }
+
+    sender = TCB_PTR(endpoint_ptr_get_epQueue_head(ep_ptr));
+
+    /* Check the sender has no extra caps, the length is ok and it is not
+     * delivering a fault. */
+    senderInfo = getRegister(sender, msgInfoRegister);
+    fault_type = seL4_Fault_get_seL4_FaultType(sender->tcbFault);
+    if (unlikely(fastpath_mi_check_length(senderInfo) ||
+                 fault_type != seL4_Fault_NullFault)) {
+        slowpath(syscall);
+    }
+
+    do_call = thread_state_ptr_get_blockingIPCIsCall(&sender->tcbState);
+    if (do_call) {
+        /* A caller without grant rights is made inactive instead of
+         * getting a reply cap. */
+        if (unlikely(!thread_state_ptr_get_blockingIPCCanGrant(&sender->tcbState) &&
+                     !thread_state_ptr_get_blockingIPCCanGrantReply(&sender->tcbState))) {
+            slowpath(syscall);
+        }
+#ifdef CONFIG_PRIORITY_INHERITANCE
+        if (unlikely(inheritsPriorityFrom(NODE_STATE(ksCurThread), sender))) {
+            slowpath(syscall);
+        }
+#endif
+    } else {
+        /* The sender becomes runnable. Only handle the case where it
+         * is queued behind the current thread on this core. */
+        if (unlikely(!fastpath_is_remote(sender) &&
+                     sender->tcbPriority > NODE_STATE(ksCurThread)->tcbPriority)) {
+            slowpath(syscall);
+        }
+        if (unlikely(sender->tcbDomain != ksCurDomain && maxDom)) {
+            slowpath(syscall);
+        }
+#ifdef CONFIG_THREAD_BUDGETS
+        if (unlikely(isThrottled(sender))) {
+            slowpath(syscall);
+        }
+#endif
+#ifdef ENABLE_SMP_SUPPORT
+        if (unlikely(NODE_STATE(ksCurThread)->tcbAffinity != sender->tcbAffinity &&
+                     !config_set(CONFIG_FASTPATH_CROSS_CORE))) {
+            slowpath(syscall);
+        }
+#endif /* ENABLE_SMP_SUPPORT */
+    }
+
+    info = messageInfoFromWord_raw(senderInfo);
+    length = seL4_MessageInfo_get_length(info);
+
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    /* Check a long message can be copied in full */
+    if (unlikely(!fastpath_lookup_buffers(length, sender, NODE_STATE(ksCurThread), &bufs))) {
+        slowpath(syscall);
+    }
+#endif
+
+    /*
+     * --- POINT OF NO RETURN ---
+     *
+     * At this stage, we have committed to performing the IPC.
+     */
+
+#ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
+    NODE_STATE(ksKernelEntry).is_fastpath = true;
+#endif
+
+    /* Dequeue the sender. */
+    endpoint_ptr_set_epQueue_head_np(ep_ptr, TCB_REF(sender->tcbEPNext));
+    if (unlikely(sender->tcbEPNext)) {
+        sender->tcbEPNext->tcbEPPrev = NULL;
+    } else {
+        endpoint_ptr_mset_epQueue_tail_state(ep_ptr, 0, EPState_Idle);
+    }
+
+    badge = thread_state_ptr_get_blockingIPCBadge(&sender->tcbState);
+
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    fastpath_copy_long_mrs(length, sender, NODE_STATE(ksCurThread), &bufs);
+#else
+    fastpath_copy_mrs(length, sender, NODE_STATE(ksCurThread));
+#endif
+
+    if (do_call) {
+        /* Block sender */
+        thread_state_ptr_set_tsType_np(&sender->tcbState,
+                                       ThreadState_BlockedOnReply);
+
+        /* Get sender reply slot */
+        replySlot = TCB_PTR_CTE_PTR(sender, tcbReply);
+
+        /* Insert reply cap */
+        cap_reply_cap_ptr_new_np(&callerSlot->cap, cap_endpoint_cap_get_capCanGrant(cap), 0,
+                                 TCB_REF(sender));
+        mdb_node_ptr_set_mdbPrev_np(&callerSlot->cteMDBNode, CTE_REF(replySlot));
+        mdb_node_ptr_mset_mdbNext_mdbRevocable_mdbFirstBadged(
+            &replySlot->cteMDBNode, CTE_REF(callerSlot), 1, 1);
+    } else {
+        thread_state_ptr_set_tsType_np(&sender->tcbState,
+                                       ThreadState_Running);
+        if (fastpath_is_remote(sender)) {
+            /* Queued on its home core, which may be sent a reschedule
+             * IPI by remoteQueueUpdate. */
+            SCHED_ENQUEUE(sender);
+        } else if (sender->tcbPriority == NODE_STATE(ksCurThread)->tcbPriority) {
+            tcbSchedAppend(sender);
+        } else {
+            tcbSchedEnqueue(sender);
+        }
+#ifdef CONFIG_FASTPATH_CROSS_CORE
+        fastpath_flush_reschedule();
+#endif /* CONFIG_FASTPATH_CROSS_CORE */
+    }
 
     msgInfo = wordFromMessageInfo(seL4_MessageInfo_set_capsUnwrapped(info, 0));
 
     fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
 }
+#endif /* CONFIG_RECV_FASTPATH */
@@ -13,6 +13,7 @@
 #include <kernel/thread.h>
 #include <machine/io.h>
 #include <machine/registerset.h>
+#include <machine/timer.h>
 #include <model/statedata.h>
 #include <arch/machine.h>
 #include <arch/kernel/boot.h>
@@ -322,11 +323,11 @@ BOOT_CODE bool_t create_idle_thread(void)
 #endif /* ENABLE_SMP_SUPPORT */
         pptr = (pptr_t) &ksIdleThreadTCB[SMP_TERNARY(i, 0)];
         NODE_STATE_ON_CORE(ksIdleThread, i) = TCB_PTR(pptr + TCB_OFFSET);
+        SMP_COND_STATEMENT(NODE_STATE_ON_CORE(ksIdleThread, i)->tcbAffinity = i);
         configureIdleThread(NODE_STATE_ON_CORE(ksIdleThread, i));
 #ifdef CONFIG_DEBUG_BUILD
         setThreadName(NODE_STATE_ON_CORE(ksIdleThread, i), "idle_thread");
 #endif
-        SMP_COND_STATEMENT(NODE_STATE_ON_CORE(ksIdleThread, i)->tcbAffinity = i);
 #ifdef ENABLE_SMP_SUPPORT
     }
 #endif /* ENABLE_SMP_SUPPORT */
@@ -338,6 +339,9 @@ BOOT_CODE tcb_t *create_initial_thread(cap_t root_cnode_cap, cap_t it_pd_cap, vp
 {
     tcb_t *tcb = TCB_PTR(rootserver.tcb + TCB_OFFSET);
     tcb->tcbTimeSlice = CONFIG_TIME_SLICE;
+#ifdef CONFIG_THREAD_TIME_SLICE
+    tcb->tcbTimeSliceLength = CONFIG_TIME_SLICE;
+#endif
     Arch_initContext(&tcb->tcbArch.tcbContext);
 
     /* derive a copy of the IPC buffer cap for inserting */
@@ -377,6 +381,9 @@ BOOT_CODE tcb_t *create_initial_thread(cap_t root_cnode_cap, cap_t it_pd_cap, vp
     ksCurDomain = ksDomSchedule[ksDomScheduleIdx].domain;
     ksDomainTime = ksDomSchedule[ksDomScheduleIdx].length;
     assert(ksCurDomain < CONFIG_NUM_DOMAINS && ksDomainTime > 0);
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+    ksCurDomScheduleLength = ksDomScheduleLength;
+#endif
 
     SMP_COND_STATEMENT(tcb->tcbAffinity = 0);
 
@@ -407,6 +414,11 @@ BOOT_CODE void init_core_state(tcb_t *scheduler_action)
 #endif
     NODE_STATE(ksSchedulerAction) = scheduler_action;
     NODE_STATE(ksCurThread) = NODE_STATE(ksIdleThread);
+#ifdef CONFIG_TICKLESS
+    /* ticks are counted from here, the timer is programmed by schedule() */
+    NODE_STATE(ksLastTick) = getTimerCount();
+    NODE_STATE(ksTimerDeadline) = 0;
+#endif /* CONFIG_TICKLESS */
 }
 
 BOOT_CODE static bool_t provide_untyped_cap(
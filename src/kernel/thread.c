@@ -20,6 +20,7 @@
 #include <arch/machine.h>
 #include <arch/kernel/thread.h>
 #include <machine/registerset.h>
+#include <machine/timer.h>
 #include <linker.h>
 
 static seL4_MessageInfo_t
@@ -251,6 +252,40 @@ void doNBRecvFailedTransfer(tcb_t *thread)
     setRegister(thread, badgeRegister, 0);
 }
 
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+/* Make the staged domain schedule the active one, starting from its first
+ * entry. Entries of the next schedule are written to the other buffer,
+ * which is cleared so that an installation can check they were all set. */
+static void installDomSchedule(void)
+{
+    ksCurDomSchedule = ksStagedDomSchedule;
+    ksCurDomScheduleLength = ksPendingDomScheduleLength;
+    ksPendingDomScheduleLength = 0;
+    ksDomScheduleIdx = 0;
+
+    if (ksStagedDomSchedule == ksDomScheduleBuffers[0]) {
+        ksStagedDomSchedule = ksDomScheduleBuffers[1];
+    } else {
+        ksStagedDomSchedule = ksDomScheduleBuffers[0];
+    }
+    memzero(ksStagedDomSchedule, sizeof(ksDomScheduleBuffers[0]));
+}
+
+static void nextDomain(void)
+{
+    if (ksPendingDomScheduleLength > 0) {
+        installDomSchedule();
+    } else {
+        ksDomScheduleIdx++;
+        if (ksDomScheduleIdx >= ksCurDomScheduleLength) {
+            ksDomScheduleIdx = 0;
+        }
+    }
+    ksWorkUnitsCompleted = 0;
+    ksCurDomain = ksCurDomSchedule[ksDomScheduleIdx].domain;
+    ksDomainTime = ksCurDomSchedule[ksDomScheduleIdx].length;
+}
+#else
 static void nextDomain(void)
 {
     ksDomScheduleIdx++;
@@ -261,6 +296,7 @@ static void nextDomain(void)
     ksCurDomain = ksDomSchedule[ksDomScheduleIdx].domain;
     ksDomainTime = ksDomSchedule[ksDomScheduleIdx].length;
 }
+#endif /* CONFIG_RUNTIME_DOMAIN_SCHEDULE */
 
 static void scheduleChooseNewThread(void)
 {
@@ -270,10 +306,274 @@ static void scheduleChooseNewThread(void)
     chooseThread();
 }
 
+#ifdef CONFIG_THREAD_BUDGETS
+/* Add a throttled TCB to the release queue of its core, after any thread
+ * whose period ends no later. The scheduler queue pointers are reused as a
+ * throttled thread is never in a ready queue. */
+void releaseEnqueue(tcb_t *tcb)
+{
+    tcb_queue_t queue = NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity);
+    tcb_t *prev = queue.end;
+
+    assert(!thread_state_get_tcbQueued(tcb->tcbState));
+
+    while (prev != NULL && prev->tcbPeriodEnd > tcb->tcbPeriodEnd) {
+        prev = prev->tcbSchedPrev;
+    }
+
+    tcb->tcbSchedPrev = prev;
+    if (prev != NULL) {
+        tcb->tcbSchedNext = prev->tcbSchedNext;
+        prev->tcbSchedNext = tcb;
+    } else {
+        tcb->tcbSchedNext = queue.head;
+        queue.head = tcb;
+    }
+
+    if (tcb->tcbSchedNext != NULL) {
+        tcb->tcbSchedNext->tcbSchedPrev = tcb;
+    } else {
+        queue.end = tcb;
+    }
+
+    NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity) = queue;
+}
+
+/* Remove a throttled TCB from the release queue of its core */
+void releaseDequeue(tcb_t *tcb)
+{
+    tcb_queue_t queue = NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity);
+
+    if (tcb->tcbSchedPrev != NULL) {
+        tcb->tcbSchedPrev->tcbSchedNext = tcb->tcbSchedNext;
+    } else {
+        queue.head = tcb->tcbSchedNext;
+    }
+
+    if (tcb->tcbSchedNext != NULL) {
+        tcb->tcbSchedNext->tcbSchedPrev = tcb->tcbSchedPrev;
+    } else {
+        queue.end = tcb->tcbSchedPrev;
+    }
+
+    NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity) = queue;
+}
+
+/* Charge the last ticks to the budget of the current thread and throttle
+ * it if the budget is exhausted */
+static void chargeBudget(uint64_t ticks)
+{
+    tcb_t *thread = NODE_STATE(ksCurThread);
+
+    if (thread->tcbPeriod == 0) {
+        return;
+    }
+
+    /* A thread throttled earlier in this kernel entry is already in the
+     * release queue and is switched away from by schedule(). No other
+     * throttled thread may run. */
+    if (isThrottled(thread) &&
+        NODE_STATE(ksSchedulerAction) != SchedulerAction_ResumeCurrentThread) {
+        return;
+    }
+    assert(!isThrottled(thread));
+
+    /* A thread that did not exhaust its budget in its last period has not
+     * been replenished yet. Its new period starts with these ticks. */
+    if (NODE_STATE(ksTicks) - ticks >= thread->tcbPeriodEnd) {
+        thread->tcbBudgetRemaining = thread->tcbBudget;
+        thread->tcbPeriodEnd = NODE_STATE(ksTicks) - ticks + thread->tcbPeriod;
+    }
+
+    if (thread->tcbBudgetRemaining > ticks) {
+        thread->tcbBudgetRemaining -= ticks;
+    } else {
+        thread->tcbBudgetRemaining = 0;
+        /* the thread may have queued itself during this kernel entry */
+        tcbSchedDequeue(thread);
+        releaseEnqueue(thread);
+        rescheduleRequired();
+    }
+}
+
+/* Replenish the throttled threads whose period has ended and make those
+ * that are still runnable schedulable again */
+static void releaseThreads(void)
+{
+    tcb_t *thread = NODE_STATE(ksReleaseQueue).head;
+
+    while (thread != NULL && thread->tcbPeriodEnd <= NODE_STATE(ksTicks)) {
+        releaseDequeue(thread);
+        thread->tcbBudgetRemaining = thread->tcbBudget;
+        thread->tcbPeriodEnd = NODE_STATE(ksTicks) + thread->tcbPeriod;
+        if (isRunnable(thread)) {
+            possibleSwitchTo(thread);
+        }
+        thread = NODE_STATE(ksReleaseQueue).head;
+    }
+}
+#endif /* CONFIG_THREAD_BUDGETS */
+
+#ifdef CONFIG_TICKLESS
+/* Account a number of ticks at once, with the same effect as that many
+ * calls to timerTick without a reschedule in between */
+static void timerTicks(uint64_t ticks)
+{
+#ifdef CONFIG_THREAD_BUDGETS
+    NODE_STATE(ksTicks) += ticks;
+#endif /* CONFIG_THREAD_BUDGETS */
+
+    if (likely(thread_state_get_tsType(NODE_STATE(ksCurThread)->tcbState) ==
+               ThreadState_Running)
+#ifdef CONFIG_VTX
+        || thread_state_get_tsType(NODE_STATE(ksCurThread)->tcbState) ==
+        ThreadState_RunningVM
+#endif
+       ) {
+#ifdef CONFIG_THREAD_BUDGETS
+        chargeBudget(ticks);
+#endif /* CONFIG_THREAD_BUDGETS */
+        if (NODE_STATE(ksCurThread)->tcbTimeSlice > ticks) {
+            NODE_STATE(ksCurThread)->tcbTimeSlice -= ticks;
+        } else {
+            /* The ticks may be charged on kernel entry, before the thread
+             * blocks. schedule() refills the slice and appends the thread
+             * to its ready queue if it is still runnable. */
+            NODE_STATE(ksCurThread)->tcbTimeSlice = 0;
+            rescheduleRequired();
+        }
+    }
+
+#ifdef CONFIG_THREAD_BUDGETS
+    releaseThreads();
+#endif /* CONFIG_THREAD_BUDGETS */
+
+#ifdef CONFIG_WORK_STEALING
+    if (CONFIG_WORK_STEALING_PERIOD > 0 &&
+        NODE_STATE(ksCurThread) == NODE_STATE(ksIdleThread)) {
+        if (ticks >= CONFIG_WORK_STEALING_PERIOD - NODE_STATE(ksWorkStealTicks)) {
+            NODE_STATE(ksWorkStealTicks) = CONFIG_WORK_STEALING_PERIOD;
+            rescheduleRequired();
+        } else {
+            NODE_STATE(ksWorkStealTicks) += ticks;
+        }
+    }
+#endif /* CONFIG_WORK_STEALING */
+
+    if (CONFIG_NUM_DOMAINS > 1) {
+        if (ksDomainTime > ticks) {
+            ksDomainTime -= ticks;
+        } else {
+            ksDomainTime = 0;
+            rescheduleRequired();
+        }
+    }
+}
+
+/* Account the whole ticks that have passed since the last one accounted,
+ * charging them to the current thread. The kernel entry points call this
+ * before handling the event, while the current thread is still the one
+ * that was running; the fastpaths leave entries with ticks pending to the
+ * slowpath. */
+void timerTicksElapsed(void)
+{
+    uint64_t tick = getTimerTickLength();
+    uint64_t ticks = (getTimerCount() - NODE_STATE(ksLastTick)) / tick;
+
+    if (ticks > 0) {
+        NODE_STATE(ksLastTick) += ticks * tick;
+        timerTicks(ticks);
+    }
+}
+
+/* Program the timer for the next tick at which the current thread may be
+ * preempted, or stop it if there is none. Called by schedule() and by the
+ * fastpaths after they switch threads. */
+void setNextTimerDeadline(void)
+{
+    uint64_t ticks = 0;
+    uint64_t deadline = 0;
+
+    if (NODE_STATE(ksCurThread) != NODE_STATE(ksIdleThread)) {
+        ticks = NODE_STATE(ksCurThread)->tcbTimeSlice;
+    }
+#ifdef CONFIG_WORK_STEALING
+    else if (CONFIG_WORK_STEALING_PERIOD > 0) {
+        /* wake for the next attempt to steal */
+        ticks = NODE_STATE(ksWorkStealTicks) < CONFIG_WORK_STEALING_PERIOD ?
+                CONFIG_WORK_STEALING_PERIOD - NODE_STATE(ksWorkStealTicks) : 1;
+    }
+#endif /* CONFIG_WORK_STEALING */
+
+#ifdef CONFIG_THREAD_BUDGETS
+    /* wake when the current thread runs out of budget or the next
+     * throttled thread is replenished */
+    if (ticks > 0 && NODE_STATE(ksCurThread)->tcbPeriod != 0 &&
+        NODE_STATE(ksCurThread)->tcbBudgetRemaining < ticks) {
+        ticks = NODE_STATE(ksCurThread)->tcbBudgetRemaining;
+    }
+    if (NODE_STATE(ksReleaseQueue).head != NULL) {
+        uint64_t periodEnd = NODE_STATE(ksReleaseQueue).head->tcbPeriodEnd;
+        uint64_t release = periodEnd > NODE_STATE(ksTicks) ? periodEnd - NODE_STATE(ksTicks) : 1;
+        if (ticks == 0 || release < ticks) {
+            ticks = release;
+        }
+    }
+#endif /* CONFIG_THREAD_BUDGETS */
+
+    if (CONFIG_NUM_DOMAINS > 1 && (ticks == 0 || ksDomainTime < ticks)) {
+        ticks = ksDomainTime;
+    }
+
+    if (ticks > 0) {
+        deadline = NODE_STATE(ksLastTick) + ticks * getTimerTickLength();
+    }
+
+    if (deadline != NODE_STATE(ksTimerDeadline)) {
+        if (deadline == 0) {
+            stopTimer();
+        } else {
+            setTimerDeadline(deadline);
+        }
+        NODE_STATE(ksTimerDeadline) = deadline;
+    }
+}
+
+void handleTimerDeadline(void)
+{
+    /* The ticks are accounted and the timer reprogrammed by schedule() */
+    stopTimer();
+    NODE_STATE(ksTimerDeadline) = 0;
+}
+#endif /* CONFIG_TICKLESS */
+
 void schedule(void)
 {
+#ifdef ENABLE_SMP_SUPPORT
+    /* Any thread made runnable on this core before this point will be
+     * seen below, so other cores need not send another reschedule IPI.
+     * The IPI may have been skipped, or not yet delivered, so act on the
+     * request here as the IPI handler would. */
+    if (clearPendingReschedule() &&
+        NODE_STATE(ksSchedulerAction) == SchedulerAction_ResumeCurrentThread) {
+        NODE_STATE(ksSchedulerAction) = SchedulerAction_ChooseNewThread;
+    }
+#endif /* ENABLE_SMP_SUPPORT */
+
+#ifdef CONFIG_TICKLESS
+    timerTicksElapsed();
+#endif /* CONFIG_TICKLESS */
+
     if (NODE_STATE(ksSchedulerAction) != SchedulerAction_ResumeCurrentThread) {
         bool_t was_runnable;
+#ifdef CONFIG_TICKLESS
+        if (NODE_STATE(ksCurThread)->tcbTimeSlice == 0) {
+            NODE_STATE(ksCurThread)->tcbTimeSlice = threadTimeSlice(NODE_STATE(ksCurThread));
+            if (isRunnable(NODE_STATE(ksCurThread))) {
+                SCHED_APPEND_CURRENT_TCB;
+            }
+        }
+#endif /* CONFIG_TICKLESS */
         if (isRunnable(NODE_STATE(ksCurThread))) {
             was_runnable = true;
             SCHED_ENQUEUE_CURRENT_TCB;
@@ -312,6 +612,9 @@ void schedule(void)
         }
     }
     NODE_STATE(ksSchedulerAction) = SchedulerAction_ResumeCurrentThread;
+#ifdef CONFIG_TICKLESS
+    setNextTimerDeadline();
+#endif /* CONFIG_TICKLESS */
 #ifdef ENABLE_SMP_SUPPORT
     doMaskReschedule(ARCH_NODE_STATE(ipiReschedulePending));
     ARCH_NODE_STATE(ipiReschedulePending) = 0;
@@ -337,6 +640,14 @@ void chooseThread(void)
         assert(isRunnable(thread));
         switchToThread(thread);
     } else {
+#ifdef CONFIG_WORK_STEALING
+        thread = stealThread(dom);
+        if (thread != NULL) {
+            assert(isRunnable(thread));
+            switchToThread(thread);
+            return;
+        }
+#endif /* CONFIG_WORK_STEALING */
         switchToIdleThread();
     }
 }
@@ -377,22 +688,113 @@ void setMCPriority(tcb_t *tptr, prio_t mcp)
     tptr->tcbMCP = mcp;
 }
 
+#ifdef CONFIG_PRIORITY_INHERITANCE
+/* Forget the caller the thread inherited its priority from */
+static void clearInheritance(tcb_t *tptr)
+{
+    if (tptr->tcbInheritedFrom) {
+        tptr->tcbInheritedFrom->tcbInheritedBy = NULL;
+        tptr->tcbInheritedFrom = NULL;
+    }
+}
+
+/* Change the priority the thread is scheduled at, moving it to the ready
+ * queue of the new priority if it is queued. A runnable thread that is
+ * not queued is running or is the scheduler action. */
+static void updatePriority(tcb_t *tptr, prio_t prio)
+{
+    if (thread_state_get_tcbQueued(tptr->tcbState)) {
+        tcbSchedDequeue(tptr);
+        tptr->tcbPriority = prio;
+        SCHED_ENQUEUE(tptr);
+    } else {
+        tptr->tcbPriority = prio;
+    }
+}
+
+/* Move a server to the priority it inherits from its caller after the
+ * caller's priority changed */
+static void followInheritedPriority(tcb_t *server)
+{
+    prio_t prio = inheritedPriority(server, server->tcbInheritedFrom);
+
+    if (prio > server->tcbBasePriority) {
+        updatePriority(server, prio);
+        rescheduleRequired();
+    } else {
+        restorePriority(server);
+    }
+}
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+
 void setPriority(tcb_t *tptr, prio_t prio)
 {
     tcbSchedDequeue(tptr);
     tptr->tcbPriority = prio;
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    /* this also ends any inheritance, and a server running at the
+     * thread's priority follows the change */
+    clearInheritance(tptr);
+    tptr->tcbBasePriority = prio;
+    if (tptr->tcbInheritedBy) {
+        followInheritedPriority(tptr->tcbInheritedBy);
+    }
+#endif
     if (isRunnable(tptr)) {
         SCHED_ENQUEUE(tptr);
         rescheduleRequired();
     }
 }
 
+#ifdef CONFIG_PRIORITY_INHERITANCE
+/* Raise the priority of a server to that of the caller it serves, up to
+ * the server's inheritance limit */
+void inheritPriority(tcb_t *server, tcb_t *caller)
+{
+    assert(inheritsPriorityFrom(server, caller));
+    assert(caller->tcbInheritedBy == NULL);
+    clearInheritance(server);
+    server->tcbInheritedFrom = caller;
+    caller->tcbInheritedBy = server;
+    updatePriority(server, inheritedPriority(server, caller));
+}
+
+/* Drop a server back to its own priority */
+void restorePriority(tcb_t *tptr)
+{
+    if (hasInheritedPriority(tptr)) {
+        clearInheritance(tptr);
+        updatePriority(tptr, tptr->tcbBasePriority);
+        if (tptr == NODE_STATE(ksCurThread)) {
+            /* threads it was inheriting above may now be runnable */
+            rescheduleRequired();
+        }
+    }
+}
+
+/* The call of a thread ended or can no longer be replied to, so the server
+ * that inherited the thread's priority for it drops back to its own */
+void endInheritance(tcb_t *caller)
+{
+    if (caller->tcbInheritedBy) {
+        restorePriority(caller->tcbInheritedBy);
+    }
+}
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+
 /* Note that this thread will possibly continue at the end of this kernel
  * entry. Do not queue it yet, since a queue+unqueue operation is wasteful
  * if it will be picked. Instead, it waits in the 'ksSchedulerAction' site
  * on which the scheduler will take action. */
 void possibleSwitchTo(tcb_t *target)
 {
+#ifdef CONFIG_THREAD_BUDGETS
+    if (isThrottled(target)) {
+        /* scheduled when it is replenished */
+        return;
+    }
+#endif /* CONFIG_THREAD_BUDGETS */
+
     if (ksCurDomain != target->tcbDomain
         SMP_COND_STATEMENT( || target->tcbAffinity != getCurrentCPUIndex())) {
         SCHED_ENQUEUE(target);
@@ -422,6 +824,10 @@ void scheduleTCB(tcb_t *tptr)
 
 void timerTick(void)
 {
+#ifdef CONFIG_THREAD_BUDGETS
+    NODE_STATE(ksTicks)++;
+#endif /* CONFIG_THREAD_BUDGETS */
+
     if (likely(thread_state_get_tsType(NODE_STATE(ksCurThread)->tcbState) ==
                ThreadState_Running)
 #ifdef CONFIG_VTX
@@ -429,15 +835,33 @@ void timerTick(void)
         ThreadState_RunningVM
 #endif
        ) {
+#ifdef CONFIG_THREAD_BUDGETS
+        chargeBudget(1);
+#endif /* CONFIG_THREAD_BUDGETS */
         if (NODE_STATE(ksCurThread)->tcbTimeSlice > 1) {
             NODE_STATE(ksCurThread)->tcbTimeSlice--;
         } else {
-            NODE_STATE(ksCurThread)->tcbTimeSlice = CONFIG_TIME_SLICE;
+            NODE_STATE(ksCurThread)->tcbTimeSlice = threadTimeSlice(NODE_STATE(ksCurThread));
             SCHED_APPEND_CURRENT_TCB;
             rescheduleRequired();
         }
     }
 
+#ifdef CONFIG_THREAD_BUDGETS
+    releaseThreads();
+#endif /* CONFIG_THREAD_BUDGETS */
+
+#ifdef CONFIG_WORK_STEALING
+    /* periodically look for work on other cores while idle */
+    if (CONFIG_WORK_STEALING_PERIOD > 0 &&
+        NODE_STATE(ksCurThread) == NODE_STATE(ksIdleThread)) {
+        NODE_STATE(ksWorkStealTicks)++;
+        if (NODE_STATE(ksWorkStealTicks) >= CONFIG_WORK_STEALING_PERIOD) {
+            rescheduleRequired();
+        }
+    }
+#endif /* CONFIG_WORK_STEALING */
+
     if (CONFIG_NUM_DOMAINS > 1) {
         ksDomainTime--;
         if (ksDomainTime == 0) {
@@ -15,12 +15,23 @@
 #include <api/failures.h>
 #include <model/statedata.h>
 #include <arch/object/structures.h>
+#include <smp/lock.h>
+#include <smp/ipi.h>
+#include <arch/smp/ipi_inline.h>
 
 #ifdef CONFIG_HAVE_FPU
 /* Switch the owner of the FPU to the given thread on local core. */
 void switchLocalFpuOwner(user_fpu_state_t *new_owner)
 {
     enableFpu();
+#ifdef ENABLE_SMP_SUPPORT
+    /* Any pending release request is for the current state, which is
+     * switched out here. If its owner was deleted it must not be saved. */
+    if (unlikely(NODE_STATE(ksFPUReleaseState)) && !NODE_STATE(ksFPUReleaseSave)) {
+        NODE_STATE(ksActiveFPUState) = NULL;
+    }
+    NODE_STATE(ksFPUReleaseState) = NULL;
+#endif /* ENABLE_SMP_SUPPORT */
     if (NODE_STATE(ksActiveFPUState)) {
         saveFpuState(NODE_STATE(ksActiveFPUState));
     }
@@ -33,16 +44,65 @@ void switchLocalFpuOwner(user_fpu_state_t *new_owner)
     NODE_STATE(ksActiveFPUState) = new_owner;
 }
 
-void switchFpuOwner(user_fpu_state_t *new_owner, word_t cpu)
-{
 #ifdef ENABLE_SMP_SUPPORT
-    if (cpu != getCurrentCPUIndex()) {
-        doRemoteswitchFpuOwner(new_owner, cpu);
-    } else
+/* Make sure the given FPU state is not live in the FPU of another core,
+ * without waiting for that core. If it is, that core is asked to release it
+ * on its next exit from the kernel, saving it first if 'save' is set, and
+ * true is returned.
+ *
+ * Requests are written and handled with the kernel lock held, so a core
+ * never saves into the FPU state of a thread that is concurrently being
+ * deleted, and a deletion overrides any earlier request to save. A request
+ * is always for the state currently active on the target core, and is
+ * satisfied by its next call to switchLocalFpuOwner. */
+static bool_t releaseRemoteFpuState(user_fpu_state_t *state, bool_t save)
+{
+    for (word_t cpu = 0; cpu < ksNumCPUs; cpu++) {
+        if (cpu != getCurrentCPUIndex() && NODE_STATE_ON_CORE(ksActiveFPUState, cpu) == state) {
+            if (NODE_STATE_ON_CORE(ksFPUReleaseState, cpu) == state) {
+                save = save && NODE_STATE_ON_CORE(ksFPUReleaseSave, cpu);
+            }
+            NODE_STATE_ON_CORE(ksFPUReleaseState, cpu) = state;
+            NODE_STATE_ON_CORE(ksFPUReleaseSave, cpu) = save;
+            /* get the core into the kernel soon */
+            ARCH_NODE_STATE(ipiReschedulePending) |= BIT(cpu);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void handleFpuReleaseRequest(void)
+{
+    /* e.g. when returning from a remote call taken without the lock */
+    if (!NODE_LOCK_HELD) {
+        return;
+    }
+
+    assert(NODE_STATE(ksActiveFPUState) == NODE_STATE(ksFPUReleaseState));
+    switchLocalFpuOwner(NULL);
+}
+
+void handleRemoteFpuRelease(user_fpu_state_t *state)
+{
+    /* The requesting core holds the lock, so the owner of the state cannot
+     * be deleted while it is saved here without the lock */
+    if (NODE_STATE(ksActiveFPUState) == state) {
+        switchLocalFpuOwner(NULL);
+    }
+}
 #endif /* ENABLE_SMP_SUPPORT */
-    {
-        switchLocalFpuOwner(new_owner);
+
+bool_t releaseUnusedFpuState(void)
+{
+    /* Saving could race with the deletion of the owner on another core */
+    if (!NODE_LOCK_HELD) {
+        return false;
     }
+
+    switchLocalFpuOwner(NULL);
+    return true;
 }
 
 /* Handle an FPU fault.
@@ -57,6 +117,19 @@ exception_t handleFPUFault(void)
      * we presumably are happy to assume will not be running seL4. */
     assert(!nativeThreadUsingFPU(NODE_STATE(ksCurThread)));
 
+#ifdef ENABLE_SMP_SUPPORT
+    /* If the thread recently changed core its state may still be in the FPU
+     * of the previous one. The thread cannot continue without it, so wait
+     * for that core to save it. This is bounded by one remote call, and
+     * only happens on the first use of the FPU after a migration. */
+    for (word_t cpu = 0; cpu < ksNumCPUs; cpu++) {
+        if (cpu != getCurrentCPUIndex() &&
+            NODE_STATE_ON_CORE(ksActiveFPUState, cpu) == &NODE_STATE(ksCurThread)->tcbArch.tcbContext.fpuState) {
+            doRemoteReleaseFpuState(&NODE_STATE(ksCurThread)->tcbArch.tcbContext.fpuState, cpu);
+        }
+    }
+#endif /* ENABLE_SMP_SUPPORT */
+
     /* Otherwise, lazily switch over the FPU. */
     switchLocalFpuOwner(&NODE_STATE(ksCurThread)->tcbArch.tcbContext.fpuState);
 
@@ -68,8 +141,26 @@ void fpuThreadDelete(tcb_t *thread)
 {
     /* If the thread being deleted currently owns the FPU, switch away from it
      * so that 'ksActiveFPUState' doesn't point to invalid memory. */
-    if (nativeThreadUsingFPU(thread)) {
-        switchFpuOwner(NULL, SMP_TERNARY(thread->tcbAffinity, 0));
+    if (NODE_STATE(ksActiveFPUState) == &thread->tcbArch.tcbContext.fpuState) {
+        switchLocalFpuOwner(NULL);
+    }
+#ifdef ENABLE_SMP_SUPPORT
+    /* The state may also be on the core the thread runs on or the one it
+     * last migrated from; that core drops it without saving */
+    releaseRemoteFpuState(&thread->tcbArch.tcbContext.fpuState, false);
+#endif /* ENABLE_SMP_SUPPORT */
+}
+
+#ifdef ENABLE_SMP_SUPPORT
+void fpuThreadMigrate(tcb_t *thread)
+{
+    /* Save the state now if it is in our FPU, otherwise have the core that
+     * holds it save it, without waiting for that core */
+    if (NODE_STATE(ksActiveFPUState) == &thread->tcbArch.tcbContext.fpuState) {
+        switchLocalFpuOwner(NULL);
+    } else {
+        releaseRemoteFpuState(&thread->tcbArch.tcbContext.fpuState, true);
     }
 }
+#endif /* ENABLE_SMP_SUPPORT */
 #endif /* CONFIG_HAVE_FPU */
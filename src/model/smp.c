@@ -13,6 +13,7 @@
 #include <config.h>
 #include <model/smp.h>
 #include <object/tcb.h>
+#include <kernel/thread.h>
 
 #ifdef ENABLE_SMP_SUPPORT
 
@@ -21,11 +22,100 @@ void migrateTCB(tcb_t *tcb, word_t new_core)
 #ifdef CONFIG_DEBUG_BUILD
     tcbDebugRemove(tcb);
 #endif
+#ifdef CONFIG_THREAD_BUDGETS
+    /* the tick counts of all cores advance together, so the end of the
+     * period stays meaningful on the new core */
+    bool_t throttled = isThrottled(tcb);
+    if (throttled) {
+        releaseDequeue(tcb);
+    }
+#endif /* CONFIG_THREAD_BUDGETS */
     Arch_migrateTCB(tcb);
     tcb->tcbAffinity = new_core;
+#ifdef CONFIG_THREAD_BUDGETS
+    if (throttled) {
+        releaseEnqueue(tcb);
+#ifdef CONFIG_TICKLESS
+        /* the new core must reprogram its timer for the release */
+        if (new_core != getCurrentCPUIndex()) {
+            ARCH_NODE_STATE(ipiReschedulePending) |= BIT(new_core);
+        }
+#endif /* CONFIG_TICKLESS */
+    }
+#endif /* CONFIG_THREAD_BUDGETS */
 #ifdef CONFIG_DEBUG_BUILD
     tcbDebugAppend(tcb);
 #endif
 }
 
+#ifdef CONFIG_WORK_STEALING
+/* Returns the highest priority migratable thread in the ready queues of
+ * the given core for the given domain, or NULL if there is none. Only the
+ * queues marked in ksMigratableBitmap are searched, and a queue found to
+ * hold no migratable thread is unmarked, so each queue is searched at most
+ * once for every time a migratable thread is queued in it. */
+static tcb_t *findMigratableThread(word_t core, word_t dom)
+{
+    for (int l1index = L2_BITMAP_SIZE - 1; l1index >= 0; l1index--) {
+        word_t *bitmap = &NODE_STATE_ON_CORE(ksMigratableBitmap[dom][l1index], core);
+        word_t l2 = *bitmap;
+
+        while (l2) {
+            word_t l2index = wordBits - 1 - clzl(l2);
+            word_t prio = l1index_to_prio(l1index) | l2index;
+            tcb_t *thread = NODE_STATE_ON_CORE(ksReadyQueues[ready_queues_index(dom, prio)], core).head;
+            bool_t marked = false;
+
+            for (; thread != NULL; thread = thread->tcbSchedNext) {
+                if (thread->tcbMigratable) {
+                    if (thread != NODE_STATE_ON_CORE(ksCurThread, core)) {
+                        return thread;
+                    }
+                    /* the current thread keeps the queue marked */
+                    marked = true;
+                }
+            }
+            if (!marked) {
+                *bitmap &= ~BIT(l2index);
+            }
+            l2 &= ~BIT(l2index);
+        }
+    }
+
+    return NULL;
+}
+
+/* Called when the current core has nothing to run. Takes the highest
+ * priority migratable thread waiting on a busy core, moves it to this
+ * core and returns it without queueing it. Returns NULL if there is none. */
+tcb_t *stealThread(word_t dom)
+{
+    tcb_t *best = NULL;
+
+    NODE_STATE(ksWorkStealTicks) = 0;
+
+    for (word_t core = 0; core < ksNumCPUs; core++) {
+        tcb_t *thread;
+
+        /* an idle core with queued threads is about to run them itself */
+        if (core == getCurrentCPUIndex() ||
+            NODE_STATE_ON_CORE(ksCurThread, core) == NODE_STATE_ON_CORE(ksIdleThread, core)) {
+            continue;
+        }
+
+        thread = findMigratableThread(core, dom);
+        if (thread != NULL && (best == NULL || thread->tcbPriority > best->tcbPriority)) {
+            best = thread;
+        }
+    }
+
+    if (best != NULL) {
+        tcbSchedDequeue(best);
+        migrateTCB(best, getCurrentCPUIndex());
+    }
+
+    return best;
+}
+#endif /* CONFIG_WORK_STEALING */
+
 #endif /* ENABLE_SMP_SUPPORT */
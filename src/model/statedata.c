@@ -52,6 +52,26 @@ UP_STATE_DEFINE(word_t, ksFPURestoresSinceSwitch);
 UP_STATE_DEFINE(tcb_t *, ksDebugTCBs);
 #endif /* CONFIG_DEBUG_BUILD */
 
+#ifdef CONFIG_THREAD_BUDGETS
+UP_STATE_DEFINE(uint64_t, ksTicks);
+UP_STATE_DEFINE(tcb_queue_t, ksReleaseQueue);
+#endif /* CONFIG_THREAD_BUDGETS */
+
+#ifdef CONFIG_TICKLESS
+UP_STATE_DEFINE(uint64_t, ksLastTick);
+UP_STATE_DEFINE(uint64_t, ksTimerDeadline);
+#endif /* CONFIG_TICKLESS */
+
+#if (defined CONFIG_DEBUG_BUILD || defined CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES \
+     || defined CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION)
+UP_STATE_DEFINE(kernel_entry_t, ksKernelEntry);
+#endif /* DEBUG */
+
+#ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
+/* Breakdown of where time has been spent */
+UP_STATE_DEFINE(benchmark_core_util_t, ksCoreUtilisation);
+#endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
+
 /* Units of work we have completed since the last time we checked for
  * pending interrupts */
 word_t ksWorkUnitsCompleted;
@@ -71,15 +91,29 @@ word_t ksDomainTime;
 /* An index into ksDomSchedule for active domain and length. */
 word_t ksDomScheduleIdx;
 
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+/* Domain schedules installed at runtime. One is staged by invocations on
+ * the domain cap while the other may be active. */
+dschedule_t ksDomScheduleBuffers[2][CONFIG_MAX_DOMAIN_SCHEDULE_LENGTH];
+
+/* Active domain schedule, which ksDomScheduleIdx indexes, and its length */
+const dschedule_t *ksCurDomSchedule = ksDomSchedule;
+word_t ksCurDomScheduleLength;
+
+/* Buffer that entries of the next schedule are written to */
+dschedule_t *ksStagedDomSchedule = ksDomScheduleBuffers[0];
+
+/* Length of the staged schedule to install at the next domain boundary,
+ * or 0 if there is none */
+word_t ksPendingDomScheduleLength;
+#endif /* CONFIG_RUNTIME_DOMAIN_SCHEDULE */
+
 /* Only used by lockTLBEntry */
 word_t tlbLockCount = 0;
 
 /* Idle thread. */
 SECTION("._idle_thread") char ksIdleThreadTCB[CONFIG_MAX_NUM_NODES][BIT(seL4_TCBBits)] ALIGN(BIT(TCB_SIZE_BITS));
 
-#if (defined CONFIG_DEBUG_BUILD || defined CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES)
-kernel_entry_t ksKernelEntry;
-#endif /* DEBUG */
 
 #ifdef CONFIG_BENCHMARK_USE_KERNEL_LOG_BUFFER
 paddr_t ksUserLogBuffer;
@@ -118,6 +118,12 @@ void receiveIPC(tcb_t *thread, cap_t cap, bool_t isBlocking)
 
     epptr = EP_PTR(cap_endpoint_cap_get_capEPPtr(cap));
 
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    /* a server receiving again no longer serves the caller it inherited
+     * the priority of */
+    restorePriority(thread);
+#endif
+
     /* Check for anything waiting in the notification */
     ntfnPtr = thread->tcbBoundNotification;
     if (ntfnPtr && notification_ptr_get_state(ntfnPtr) == NtfnState_Active) {
@@ -144,7 +144,7 @@ void invokeIRQHandler_AckIRQ(irq_t irq)
 #else
 #if defined ENABLE_SMP_SUPPORT && defined CONFIG_ARCH_ARM
     if (IRQ_IS_PPI(irq) && IDX_TO_CORE(irq) != getCurrentCPUIndex()) {
-        doRemoteMaskPrivateInterrupt(IDX_TO_CORE(irq), false, irq);
+        doRemoteAckPrivateInterrupt(IDX_TO_CORE(irq), irq);
         return;
     }
 #endif
@@ -219,8 +219,12 @@ void handleInterrupt(irq_t irq)
     }
 
     case IRQTimer:
+#ifdef CONFIG_TICKLESS
+        handleTimerDeadline();
+#else
         timerTick();
         resetTimer();
+#endif /* CONFIG_TICKLESS */
         break;
 
 #ifdef ENABLE_SMP_SUPPORT
@@ -124,6 +124,15 @@ finaliseCap_ret_t finaliseCap(cap_t cap, bool_t final, bool_t exposed)
         return fc_ret;
 
     case cap_reply_cap:
+#ifdef CONFIG_PRIORITY_INHERITANCE
+        /* Reply caps cannot be copied, so the caller can no longer be
+         * replied to. This covers replies, cancelled calls and deleted
+         * callers. */
+        if (!cap_reply_cap_get_capReplyMaster(cap)) {
+            endInheritance(TCB_PTR(cap_reply_cap_get_capTCBPtr(cap)));
+        }
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+        /* fall through */
     case cap_null_cap:
     case cap_domain_cap:
         fc_ret.remainder = cap_null_cap_new();
@@ -160,6 +169,15 @@ finaliseCap_ret_t finaliseCap(cap_t cap, bool_t final, bool_t exposed)
             cte_ptr = TCB_PTR_CTE_PTR(tcb, tcbCTable);
             unbindNotification(tcb);
             suspend(tcb);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+            /* the caller it serves must not point at a deleted server */
+            restorePriority(tcb);
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+#ifdef CONFIG_THREAD_BUDGETS
+            if (isThrottled(tcb)) {
+                releaseDequeue(tcb);
+            }
+#endif /* CONFIG_THREAD_BUDGETS */
 #ifdef CONFIG_DEBUG_BUILD
             tcbDebugRemove(tcb);
 #endif
@@ -442,6 +460,9 @@ cap_t createObject(object_t t, void *regionBase, word_t userSize, bool_t deviceM
 
         Arch_initContext(&tcb->tcbArch.tcbContext);
         tcb->tcbTimeSlice = CONFIG_TIME_SLICE;
+#ifdef CONFIG_THREAD_TIME_SLICE
+        tcb->tcbTimeSliceLength = CONFIG_TIME_SLICE;
+#endif
         tcb->tcbDomain = ksCurDomain;
 
         /* Initialize the new TCB to the current core */
@@ -66,6 +66,17 @@ static inline void addToBitmap(word_t cpu, word_t dom, word_t prio)
     NODE_STATE_ON_CORE(ksReadyQueuesL2Bitmap[dom][l1index_inverted], cpu) |= BIT(prio & MASK(wordRadix));
 }
 
+#ifdef CONFIG_WORK_STEALING
+/* Mark the ready queue of a queued migratable thread for stealThread */
+static inline void addToMigratableBitmap(tcb_t *tcb)
+{
+    if (tcb->tcbMigratable) {
+        NODE_STATE_ON_CORE(ksMigratableBitmap[tcb->tcbDomain][prio_to_l1index(tcb->tcbPriority)],
+                           tcb->tcbAffinity) |= BIT(tcb->tcbPriority & MASK(wordRadix));
+    }
+}
+#endif /* CONFIG_WORK_STEALING */
+
 static inline void removeFromBitmap(word_t cpu, word_t dom, word_t prio)
 {
     word_t l1index;
@@ -82,6 +93,13 @@ static inline void removeFromBitmap(word_t cpu, word_t dom, word_t prio)
 /* Add TCB to the head of a scheduler queue */
 void tcbSchedEnqueue(tcb_t *tcb)
 {
+#ifdef CONFIG_THREAD_BUDGETS
+    if (isThrottled(tcb)) {
+        /* queued when it is replenished */
+        return;
+    }
+#endif /* CONFIG_THREAD_BUDGETS */
+
     if (!thread_state_get_tcbQueued(tcb->tcbState)) {
         tcb_queue_t queue;
         dom_t dom;
@@ -106,12 +124,22 @@ void tcbSchedEnqueue(tcb_t *tcb)
         NODE_STATE_ON_CORE(ksReadyQueues[idx], tcb->tcbAffinity) = queue;
 
         thread_state_ptr_set_tcbQueued(&tcb->tcbState, true);
+#ifdef CONFIG_WORK_STEALING
+        addToMigratableBitmap(tcb);
+#endif /* CONFIG_WORK_STEALING */
     }
 }
 
 /* Add TCB to the end of a scheduler queue */
 void tcbSchedAppend(tcb_t *tcb)
 {
+#ifdef CONFIG_THREAD_BUDGETS
+    if (isThrottled(tcb)) {
+        /* queued when it is replenished */
+        return;
+    }
+#endif /* CONFIG_THREAD_BUDGETS */
+
     if (!thread_state_get_tcbQueued(tcb->tcbState)) {
         tcb_queue_t queue;
         dom_t dom;
@@ -136,6 +164,9 @@ void tcbSchedAppend(tcb_t *tcb)
         NODE_STATE_ON_CORE(ksReadyQueues[idx], tcb->tcbAffinity) = queue;
 
         thread_state_ptr_set_tcbQueued(&tcb->tcbState, true);
+#ifdef CONFIG_WORK_STEALING
+        addToMigratableBitmap(tcb);
+#endif /* CONFIG_WORK_STEALING */
     }
 }
 
@@ -271,6 +302,11 @@ void setupCallerCap(tcb_t *sender, tcb_t *receiver, bool_t canGrant)
     assert(cap_get_capType(callerCap) == cap_null_cap);
     cteInsert(cap_reply_cap_new(canGrant, false, TCB_REF(sender)),
               replySlot, callerSlot);
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    if (inheritsPriorityFrom(receiver, sender)) {
+        inheritPriority(receiver, sender);
+    }
+#endif
 }
 
 void deleteCallerCap(tcb_t *receiver)
@@ -408,8 +444,216 @@ static exception_t decodeSetAffinity(cap_t cap, word_t length, word_t *buffer)
     setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
     return invokeTCB_SetAffinity(tcb, affinity);
 }
+
+#ifdef CONFIG_WORK_STEALING
+static exception_t invokeTCB_SetMigratable(tcb_t *thread, bool_t migratable)
+{
+    thread->tcbMigratable = migratable;
+    if (thread_state_get_tcbQueued(thread->tcbState)) {
+        addToMigratableBitmap(thread);
+    }
+    return EXCEPTION_NONE;
+}
+
+static exception_t decodeSetMigratable(cap_t cap, word_t length, word_t *buffer)
+{
+    tcb_t *tcb;
+
+    if (length < 1) {
+        userError("TCB SetMigratable: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    tcb = TCB_PTR(cap_thread_cap_get_capTCBPtr(cap));
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return invokeTCB_SetMigratable(tcb, getSyscallArg(0, buffer) != 0);
+}
+#endif /* CONFIG_WORK_STEALING */
 #endif /* ENABLE_SMP_SUPPORT */
 
+#ifdef CONFIG_THREAD_TIME_SLICE
+static exception_t invokeTCB_SetTimeSlice(tcb_t *thread, word_t slice)
+{
+    thread->tcbTimeSliceLength = slice;
+    /* a shortened slice takes effect immediately */
+    if (thread->tcbTimeSlice > slice) {
+        thread->tcbTimeSlice = slice;
+    }
+    return EXCEPTION_NONE;
+}
+
+static exception_t decodeSetTimeSlice(cap_t cap, word_t length, extra_caps_t excaps, word_t *buffer)
+{
+    if (length < 1 || excaps.excaprefs[0] == NULL) {
+        userError("TCB SetTimeSlice: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    word_t slice = getSyscallArg(0, buffer);
+    cap_t authCap = excaps.excaprefs[0]->cap;
+
+    if (cap_get_capType(authCap) != cap_thread_cap) {
+        userError("TCB SetTimeSlice: authority cap not a TCB.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (slice == 0 || slice > MAX_TIME_SLICE_TICKS) {
+        userError("TCB SetTimeSlice: Time slice %lu out of range.", (unsigned long) slice);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 1;
+        current_syscall_error.rangeErrorMax = MAX_TIME_SLICE_TICKS;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* only threads the authority could have given their own priority
+     * may have their time slice changed */
+    tcb_t *tcb = TCB_PTR(cap_thread_cap_get_capTCBPtr(cap));
+    tcb_t *authTCB = TCB_PTR(cap_thread_cap_get_capTCBPtr(authCap));
+    prio_t prio = threadBasePriority(tcb);
+    exception_t status = checkPrio(prio, authTCB);
+    if (status != EXCEPTION_NONE) {
+        userError("TCB SetTimeSlice: Thread priority %lu above authority's mcp %lu.",
+                  (unsigned long) prio, (unsigned long) authTCB->tcbMCP);
+        return status;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return invokeTCB_SetTimeSlice(tcb, slice);
+}
+#endif /* CONFIG_THREAD_TIME_SLICE */
+
+#ifdef CONFIG_THREAD_BUDGETS
+static exception_t invokeTCB_SetBudget(tcb_t *thread, word_t budget, word_t period)
+{
+    bool_t throttled = isThrottled(thread);
+
+    if (throttled) {
+        releaseDequeue(thread);
+    }
+
+    /* the thread starts a new period with its full budget */
+    thread->tcbBudget = budget;
+    thread->tcbPeriod = period;
+    thread->tcbBudgetRemaining = budget;
+    thread->tcbPeriodEnd = NODE_STATE_ON_CORE(ksTicks, thread->tcbAffinity) + period;
+
+    if (throttled && isRunnable(thread)) {
+        SCHED_ENQUEUE(thread);
+        rescheduleRequired();
+    }
+    return EXCEPTION_NONE;
+}
+
+static exception_t decodeSetBudget(cap_t cap, word_t length, extra_caps_t excaps, word_t *buffer)
+{
+    if (length < 2 || excaps.excaprefs[0] == NULL) {
+        userError("TCB SetBudget: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    word_t budget = getSyscallArg(0, buffer);
+    word_t period = getSyscallArg(1, buffer);
+    cap_t authCap = excaps.excaprefs[0]->cap;
+
+    if (cap_get_capType(authCap) != cap_thread_cap) {
+        userError("TCB SetBudget: authority cap not a TCB.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (period > MAX_BUDGET_PERIOD_TICKS) {
+        userError("TCB SetBudget: Period %lu too long.", (unsigned long) period);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = MAX_BUDGET_PERIOD_TICKS;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* a period of 0 removes the limit */
+    if (period == 0) {
+        budget = 0;
+    } else if (budget == 0 || budget > period) {
+        userError("TCB SetBudget: Budget %lu must be between 1 and the period %lu.",
+                  (unsigned long) budget, (unsigned long) period);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 1;
+        current_syscall_error.rangeErrorMax = period;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* only threads the authority could have given their own priority
+     * may have their budget changed */
+    tcb_t *tcb = TCB_PTR(cap_thread_cap_get_capTCBPtr(cap));
+    tcb_t *authTCB = TCB_PTR(cap_thread_cap_get_capTCBPtr(authCap));
+    prio_t prio = threadBasePriority(tcb);
+    exception_t status = checkPrio(prio, authTCB);
+    if (status != EXCEPTION_NONE) {
+        userError("TCB SetBudget: Thread priority %lu above authority's mcp %lu.",
+                  (unsigned long) prio, (unsigned long) authTCB->tcbMCP);
+        return status;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return invokeTCB_SetBudget(tcb, budget, period);
+}
+#endif /* CONFIG_THREAD_BUDGETS */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+static exception_t invokeTCB_SetPriorityInheritance(tcb_t *thread, bool_t inherit, prio_t mcp)
+{
+    if (inherit && !thread->tcbInheritPriority) {
+        thread->tcbBasePriority = thread->tcbPriority;
+    } else if (!inherit || thread->tcbPriority > mcp) {
+        /* also drop a priority inherited above the new limit */
+        restorePriority(thread);
+    }
+    thread->tcbInheritPriority = inherit;
+    thread->tcbInheritMCP = mcp;
+    return EXCEPTION_NONE;
+}
+
+static exception_t decodeSetPriorityInheritance(cap_t cap, word_t length, extra_caps_t excaps, word_t *buffer)
+{
+    if (length < 1 || excaps.excaprefs[0] == NULL) {
+        userError("TCB SetPriorityInheritance: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    bool_t inherit = getSyscallArg(0, buffer) != 0;
+    cap_t authCap = excaps.excaprefs[0]->cap;
+
+    if (cap_get_capType(authCap) != cap_thread_cap) {
+        userError("TCB SetPriorityInheritance: authority cap not a TCB.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* only threads the authority could have given their own priority
+     * may inherit, and never above the authority's MCP */
+    tcb_t *tcb = TCB_PTR(cap_thread_cap_get_capTCBPtr(cap));
+    tcb_t *authTCB = TCB_PTR(cap_thread_cap_get_capTCBPtr(authCap));
+    prio_t prio = threadBasePriority(tcb);
+    exception_t status = checkPrio(prio, authTCB);
+    if (status != EXCEPTION_NONE) {
+        userError("TCB SetPriorityInheritance: Thread priority %lu above authority's mcp %lu.",
+                  (unsigned long) prio, (unsigned long) authTCB->tcbMCP);
+        return status;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return invokeTCB_SetPriorityInheritance(tcb, inherit, authTCB->tcbMCP);
+}
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+
 #ifdef CONFIG_HARDWARE_DEBUG_API
 static exception_t invokeConfigureSingleStepping(word_t *buffer, tcb_t *t,
                                                  uint16_t bp_num, word_t n_instrs)
@@ -725,6 +969,26 @@ exception_t decodeTCBInvocation(word_t invLabel, word_t length, cap_t cap,
         return decodeSetAffinity(cap, length, buffer);
 #endif /* ENABLE_SMP_SUPPORT */
 
+#ifdef CONFIG_WORK_STEALING
+    case TCBSetMigratable:
+        return decodeSetMigratable(cap, length, buffer);
+#endif /* CONFIG_WORK_STEALING */
+
+#ifdef CONFIG_THREAD_TIME_SLICE
+    case TCBSetTimeSlice:
+        return decodeSetTimeSlice(cap, length, excaps, buffer);
+#endif /* CONFIG_THREAD_TIME_SLICE */
+
+#ifdef CONFIG_THREAD_BUDGETS
+    case TCBSetBudget:
+        return decodeSetBudget(cap, length, excaps, buffer);
+#endif /* CONFIG_THREAD_BUDGETS */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+    case TCBSetPriorityInheritance:
+        return decodeSetPriorityInheritance(cap, length, excaps, buffer);
+#endif /* CONFIG_PRIORITY_INHERITANCE */
+
         /* There is no notion of arch specific TCB invocations so this needs to go here */
 #ifdef CONFIG_VTX
     case TCBSetEPTRoot:
@@ -1225,11 +1489,109 @@ exception_t decodeSetSpace(cap_t cap, word_t length, cte_t *slot,
                0, cap_null_cap_new(), NULL, thread_control_update_space);
 }
 
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+static exception_t decodeDomainScheduleConfigure(word_t length, word_t *buffer)
+{
+    word_t index, domain, domLength;
+
+    if (unlikely(length < 3)) {
+        userError("Domain ScheduleConfigure: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* the staged entries become the active schedule at the next domain
+     * boundary and must not change before then */
+    if (unlikely(ksPendingDomScheduleLength != 0)) {
+        userError("Domain ScheduleConfigure: a schedule is waiting to be installed.");
+        current_syscall_error.type = seL4_IllegalOperation;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    index = getSyscallArg(0, buffer);
+    domain = getSyscallArg(1, buffer);
+    domLength = getSyscallArg(2, buffer);
+
+    if (index >= CONFIG_MAX_DOMAIN_SCHEDULE_LENGTH) {
+        userError("Domain ScheduleConfigure: invalid index (%lu >= %u).",
+                  index, CONFIG_MAX_DOMAIN_SCHEDULE_LENGTH);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = CONFIG_MAX_DOMAIN_SCHEDULE_LENGTH - 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (domain >= CONFIG_NUM_DOMAINS) {
+        userError("Domain ScheduleConfigure: invalid domain (%lu >= %u).",
+                  domain, CONFIG_NUM_DOMAINS);
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (domLength == 0 || domLength > MAX_DOMAIN_LENGTH_TICKS) {
+        userError("Domain ScheduleConfigure: invalid length %lu.", domLength);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 1;
+        current_syscall_error.rangeErrorMax = MAX_DOMAIN_LENGTH_TICKS;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    ksStagedDomSchedule[index].domain = domain;
+    ksStagedDomSchedule[index].length = domLength;
+    return EXCEPTION_NONE;
+}
+
+static exception_t decodeDomainScheduleInstall(word_t length, word_t *buffer)
+{
+    word_t schedLength;
+
+    if (unlikely(length < 1)) {
+        userError("Domain ScheduleInstall: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    schedLength = getSyscallArg(0, buffer);
+    if (schedLength == 0 || schedLength > CONFIG_MAX_DOMAIN_SCHEDULE_LENGTH) {
+        userError("Domain ScheduleInstall: invalid length %lu.", schedLength);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 1;
+        current_syscall_error.rangeErrorMax = CONFIG_MAX_DOMAIN_SCHEDULE_LENGTH;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* every entry must have been configured since the last installation */
+    for (word_t i = 0; i < schedLength; i++) {
+        if (ksStagedDomSchedule[i].length == 0) {
+            userError("Domain ScheduleInstall: entry %lu not configured.", i);
+            current_syscall_error.type = seL4_InvalidArgument;
+            current_syscall_error.invalidArgumentNumber = 0;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    ksPendingDomScheduleLength = schedLength;
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_RUNTIME_DOMAIN_SCHEDULE */
+
 exception_t decodeDomainInvocation(word_t invLabel, word_t length, extra_caps_t excaps, word_t *buffer)
 {
     word_t domain;
     cap_t tcap;
 
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+    if (invLabel == DomainSetScheduleConfigure) {
+        return decodeDomainScheduleConfigure(length, buffer);
+    }
+    if (invLabel == DomainSetScheduleInstall) {
+        return decodeDomainScheduleInstall(length, buffer);
+    }
+#endif /* CONFIG_RUNTIME_DOMAIN_SCHEDULE */
+
     if (unlikely(invLabel != DomainSetSet)) {
         current_syscall_error.type = seL4_IllegalOperation;
         return EXCEPTION_SYSCALL_ERROR;
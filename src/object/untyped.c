@@ -20,6 +20,7 @@
 #include <object/cnode.h>
 #include <kernel/cspace.h>
 #include <kernel/thread.h>
+#include <kernel/vspace.h>
 #include <util.h>
 
 static word_t alignUp(word_t baseValue, word_t alignment)
@@ -280,6 +281,9 @@ exception_t invokeUntyped_Retype(cte_t *srcSlot,
 
     freeRef = GET_FREE_REF(regionBase, cap_untyped_cap_get_capFreeIndex(srcSlot->cap));
 
+    /* other cores must not reach the memory through stale translations */
+    Arch_flushDeferredTranslations();
+
     if (reset) {
         status = resetUntypedCap(srcSlot);
         if (status != EXCEPTION_NONE) {
@@ -16,6 +16,37 @@
 #include <smp/lock.h>
 
 #ifdef ENABLE_SMP_SUPPORT
+/* Remote calls waiting to be run, one queue per target core */
+static remote_call_queue_t remoteCallQueues[CONFIG_MAX_NUM_NODES] ALIGN(L1_CACHE_LINE_SIZE);
+
+/* Each core has one synchronous and one asynchronous remote call in flight
+ * at a time, indexed by 'isAsync', with a queue node for each target core */
+static remote_call_t remoteCalls[CONFIG_MAX_NUM_NODES][2];
+static remote_call_node_t remoteCallNodes[CONFIG_MAX_NUM_NODES][2][CONFIG_MAX_NUM_NODES];
+
+/* Set while a reschedule IPI sent to a core has not been acted on by it.
+ * Further reschedule requests for that core are dropped in the meantime. */
+static struct {
+    word_t pending;
+
+    PAD_TO_NEXT_CACHE_LN(sizeof(word_t));
+} rescheduleIPIPending[CONFIG_MAX_NUM_NODES] ALIGN(L1_CACHE_LINE_SIZE);
+
+word_t ksRescheduleIPIsSuppressed;
+
+/* Signal the initiator of the remote call being run on this core that it
+ * has completed. After this the descriptor may be reused. */
+static void completeRemoteCall(void)
+{
+    remote_call_queue_t *queue = &remoteCallQueues[getCurrentCPUIndex()];
+    remote_call_t *call = queue->current;
+
+    if (call) {
+        queue->current = NULL;
+        __atomic_fetch_sub(&call->pending, 1, __ATOMIC_RELEASE);
+    }
+}
+
 /* This function switches the core it is called on to the idle thread,
  * in order to avoid IPI storms. If the core is waiting on the lock, the actual
  * switch will not occur until the core attempts to obtain the lock, at which
@@ -41,15 +72,20 @@ void ipiStallCoreCallback(bool_t irqPath)
         NODE_STATE(ksSchedulerAction) = SchedulerAction_ResumeCurrentThread;
 
         /* Let the cpu requesting this IPI to continue while we waiting on lock */
-        big_kernel_lock.node_owners[getCurrentCPUIndex()].ipi = 0;
-        ipi_wait(totalCoreBarrier);
+        completeRemoteCall();
+
+        /* Calls queued behind this one are run while waiting on the lock */
+        if (remoteCallQueues[getCurrentCPUIndex()].local) {
+            big_kernel_lock.node_owners[getCurrentCPUIndex()].ipi = 1;
+        }
 
         /* Continue waiting on lock */
-        while (big_kernel_lock.node_owners[getCurrentCPUIndex()].next->value != CLHState_Granted) {
+        while (!clh_lock_granted(getCurrentCPUIndex())) {
             if (clh_is_ipi_pending(getCurrentCPUIndex())) {
 
                 /* Multiple calls for similar reason could result in stack overflow */
-                assert((IpiRemoteCall_t)remoteCall != IpiRemoteCall_Stall);
+                assert(!remoteCallQueues[getCurrentCPUIndex()].local ||
+                       remoteCallQueues[getCurrentCPUIndex()].local->call->call != IpiRemoteCall_Stall);
                 handleIPI(irq_remote_call_ipi, irqPath);
             }
             arch_pause();
@@ -58,6 +94,17 @@ void ipiStallCoreCallback(bool_t irqPath)
         /* make sure no resource access passes from this point */
         asm volatile("" ::: "memory");
 
+#ifdef CONFIG_FASTPATH_FINE_GRAINED_LOCKING
+        fastpath_lock_drain(getCurrentCPUIndex());
+#endif
+#ifdef CONFIG_BENCHMARK_TRACK_LOCK_CONTENTION
+        /* The lock is held for this remote call, not for the kernel entry
+         * this core recorded last */
+        NODE_STATE(ksKernelEntry).path = Entry_Interrupt;
+        NODE_STATE(ksKernelEntry).word = irq_remote_call_ipi;
+        benchmark_lock_acquired(getCurrentCPUIndex());
+#endif
+
         /* Start idle thread to capture the pending IPI */
         activateThread();
         restore_user_context();
@@ -73,10 +120,85 @@ void ipiStallCoreCallback(bool_t irqPath)
     }
 }
 
+static void handleRemoteCalls(bool_t irqPath)
+{
+    remote_call_queue_t *queue = &remoteCallQueues[getCurrentCPUIndex()];
+    remote_call_node_t *node, *next, *posted = NULL;
+    remote_call_node_t **tail;
+
+    /* Clear the flag before taking the queue, so that a call posted after
+     * this point sets it again */
+    big_kernel_lock.node_owners[getCurrentCPUIndex()].ipi = 0;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    /* The most recently posted call is at the head, reverse the list so
+     * that calls are run in the order they were posted */
+    node = __atomic_exchange_n(&queue->head, NULL, __ATOMIC_ACQUIRE);
+    while (node) {
+        next = node->next;
+        node->next = posted;
+        posted = node;
+        node = next;
+    }
+
+    /* Run them after any left over from a call that did not return */
+    for (tail = &queue->local; *tail; tail = &(*tail)->next);
+    *tail = posted;
+
+    while (queue->local) {
+        node = queue->local;
+        queue->local = node->next;
+        queue->current = node->call;
+        handleRemoteCall(node->call->call, node->call->args[0], node->call->args[1],
+                         node->call->args[2], irqPath);
+        completeRemoteCall();
+    }
+}
+
+static void postRemoteCall(bool_t isAsync, IpiRemoteCall_t func,
+                           word_t data1, word_t data2, word_t data3, word_t mask)
+{
+    remote_call_t *call = &remoteCalls[getCurrentCPUIndex()][isAsync];
+    remote_call_node_t *nodes = remoteCallNodes[getCurrentCPUIndex()][isAsync];
+    word_t targets = mask;
+
+    /* The previous call made with this descriptor may still be queued */
+    while (__atomic_load_n(&call->pending, __ATOMIC_ACQUIRE) != 0) {
+        arch_pause();
+    }
+
+    call->call = func;
+    call->args[0] = data1;
+    call->args[1] = data2;
+    call->args[2] = data3;
+    call->pending = popcountl(mask);
+
+    while (targets) {
+        int index = wordBits - 1 - clzl(targets);
+        remote_call_queue_t *queue = &remoteCallQueues[index];
+        remote_call_node_t *head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+
+        nodes[index].call = call;
+        do {
+            nodes[index].next = head;
+        } while (!__atomic_compare_exchange_n(&queue->head, &head, &nodes[index], true,
+                                              __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+        targets &= ~BIT(index);
+    }
+
+    /* The calls must be visible before the targets see their IPI flag */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ipi_send_mask(irq_remote_call_ipi, mask, true);
+}
+
 void handleIPI(irq_t irq, bool_t irqPath)
 {
     if (IDX_TO_IRQ(irq) == irq_remote_call_ipi) {
-        handleRemoteCall(remoteCall, get_ipi_arg(0), get_ipi_arg(1), get_ipi_arg(2), irqPath);
+        /* we gets spurious irq_remote_call_ipi calls, e.g. when handling IPI
+         * in lock while hardware IPI is pending. Guard against spurious IPIs! */
+        if (clh_is_ipi_pending(getCurrentCPUIndex())) {
+            handleRemoteCalls(irqPath);
+        }
     } else if (IDX_TO_IRQ(irq) == irq_reschedule_ipi) {
         rescheduleRequired();
     } else {
@@ -92,24 +214,74 @@ void doRemoteMaskOp(IpiRemoteCall_t func, word_t data1, word_t data2, word_t dat
     /* this may happen, e.g. the caller tries to map a pagetable in
      * newly created PD which has not been run yet. Guard against them! */
     if (mask != 0) {
-        init_ipi_args(func, data1, data2, data3, mask);
+        remote_call_t *call = &remoteCalls[getCurrentCPUIndex()][false];
 
-        /* make sure no resource access passes from this point */
-        asm volatile("" ::: "memory");
-        ipi_send_mask(irq_remote_call_ipi, mask, true);
-        ipi_wait(totalCoreBarrier);
+        postRemoteCall(false, func, data1, data2, data3, mask);
+
+        /* wait for the target cores to run the call */
+        while (__atomic_load_n(&call->pending, __ATOMIC_ACQUIRE) != 0) {
+            arch_pause();
+        }
+    }
+}
+
+void doRemoteMaskOpAsync(IpiRemoteCall_t func, word_t data1, word_t data2, word_t data3, word_t mask)
+{
+    /* make sure the current core is not set in the mask */
+    mask &= ~BIT(getCurrentCPUIndex());
+
+    if (mask != 0) {
+        postRemoteCall(true, func, data1, data2, data3, mask);
     }
 }
 
 void doMaskReschedule(word_t mask)
 {
+    word_t targets;
+
     /* make sure the current core is not set in the mask */
     mask &= ~BIT(getCurrentCPUIndex());
+
+    /* drop cores that have not yet acted on an earlier reschedule IPI */
+    targets = mask;
+    while (targets) {
+        int index = wordBits - 1 - clzl(targets);
+        if (__atomic_exchange_n(&rescheduleIPIPending[index].pending, 1, __ATOMIC_ACQ_REL)) {
+            mask &= ~BIT(index);
+            __atomic_fetch_add(&ksRescheduleIPIsSuppressed, 1, __ATOMIC_RELAXED);
+        }
+#ifdef CONFIG_X86_IDLE_MWAIT
+        else if (NODE_STATE_ON_CORE(ksCurThread, index) == NODE_STATE_ON_CORE(ksIdleThread, index)) {
+            /* The idle thread is monitoring the flag we just set. If the core
+             * is instead in the kernel, schedule() sees the flag on its way
+             * out and picks a new thread. */
+            mask &= ~BIT(index);
+        }
+#endif /* CONFIG_X86_IDLE_MWAIT */
+        targets &= ~BIT(index);
+    }
+
     if (mask != 0) {
         ipi_send_mask(irq_reschedule_ipi, mask, false);
     }
 }
 
+#ifdef CONFIG_X86_IDLE_MWAIT
+BOOT_CODE word_t *getRescheduleWakeWord(word_t core)
+{
+    return &rescheduleIPIPending[core].pending;
+}
+#endif /* CONFIG_X86_IDLE_MWAIT */
+
+bool_t clearPendingReschedule(void)
+{
+    if (rescheduleIPIPending[getCurrentCPUIndex()].pending) {
+        __atomic_store_n(&rescheduleIPIPending[getCurrentCPUIndex()].pending, 0, __ATOMIC_RELEASE);
+        return true;
+    }
+    return false;
+}
+
 void generic_ipi_send_mask(irq_t ipi, word_t mask, bool_t isBlocking)
 {
     word_t nr_target_cores = 0;
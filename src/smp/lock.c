@@ -15,10 +15,15 @@
 
 #ifdef ENABLE_SMP_SUPPORT
 
-clh_lock_t big_kernel_lock ALIGN(L1_CACHE_LINE_SIZE);
+kernel_lock_t big_kernel_lock ALIGN(L1_CACHE_LINE_SIZE);
+
+#ifdef CONFIG_FASTPATH_FINE_GRAINED_LOCKING
+fastpath_lock_t fastpath_lock ALIGN(L1_CACHE_LINE_SIZE);
+#endif
 
 BOOT_CODE void clh_lock_init(void)
 {
+#ifdef CONFIG_LOCK_CLH
     for (int i = 0; i < CONFIG_MAX_NUM_NODES; i++) {
         big_kernel_lock.node_owners[i].node = &big_kernel_lock.nodes[i];
     }
@@ -26,6 +31,8 @@ BOOT_CODE void clh_lock_init(void)
     /* Initialize the CLH head */
     big_kernel_lock.nodes[CONFIG_MAX_NUM_NODES].value = CLHState_Granted;
     big_kernel_lock.head = &big_kernel_lock.nodes[CONFIG_MAX_NUM_NODES];
+#endif /* CONFIG_LOCK_CLH */
+    /* the other algorithms start out unlocked with all fields zero */
 }
 
 #endif /* ENABLE_SMP_SUPPORT */
@@ -45,34 +45,43 @@ KERNEL_HEADER_TEMPLATE = """/*
 """ + COMMON_HEADER + """
 #ifndef __ARCH_API_SYSCALL_H
 #define __ARCH_API_SYSCALL_H
+{% for condition, macro, count in optional %}
+#if {{condition}}
+#define {{macro}} {{count}}
+#else
+#define {{macro}} 0
+#endif /* {{condition}} */
+{%- endfor %}
 
 #ifdef __ASSEMBLER__
 
 /* System Calls */
-{%- set ns = namespace(syscall_number=-1) -%}
 {%- for condition, list in assembler  -%}
-    {%- for syscall in list %}
-#define SYSCALL_{{upper(syscall)}} ({{ns.syscall_number}})
-    {%- set ns.syscall_number = ns.syscall_number -1 -%}
+   {%- if condition | length > 0 %}
+#if {{condition}}
+   {%- endif %}
+    {%- for syscall, number in list %}
+#define SYSCALL_{{upper(syscall)}} ({{number}})
     {%- endfor  %}
+   {%- if condition | length > 0 %}
+#endif /* {{condition}} */
+   {%- endif %}
 {%- endfor  %}
 
 #endif
 
 #define SYSCALL_MAX (-1)
-#define SYSCALL_MIN ({{ns.syscall_number+ 1}})
+#define SYSCALL_MIN ({{syscall_min}})
 
 #ifndef __ASSEMBLER__
 
 enum syscall {
-{%- set ns.syscall_number = -1 -%}
 {% for condition, list in enum %}
    {%- if condition | length > 0 %}
 #if {{condition}}
    {%- endif %}
-   {%- for syscall in list %}
-    Sys{{syscall}} = {{ns.syscall_number}},
-    {%- set ns.syscall_number = ns.syscall_number -1 -%}
+   {%- for syscall, number in list %}
+    Sys{{syscall}} = {{number}},
    {%- endfor %}
    {%- if condition | length > 0 %}
 #endif /* {{condition}} */
@@ -84,12 +93,16 @@ typedef word_t syscall_t;
 /* System call names */
 #ifdef CONFIG_DEBUG_BUILD
 static char *syscall_names[] UNUSED = {
-{%- set ns.syscall_number = 1 -%}
 {%- for condition, list in assembler %}
-   {%- for syscall in list %}
-         [{{ns.syscall_number}}] = "{{syscall}}",
-        {%- set ns.syscall_number = ns.syscall_number +1 -%}
+   {%- if condition | length > 0 %}
+#if {{condition}}
+   {%- endif %}
+   {%- for syscall, number in list %}
+         [-({{number}})] = "{{syscall}}",
    {%- endfor %}
+   {%- if condition | length > 0 %}
+#endif /* {{condition}} */
+   {%- endif %}
 {%- endfor %}
 };
 #endif /* CONFIG_DEBUG_BUILD */
@@ -117,16 +130,21 @@ LIBSEL4_HEADER_TEMPLATE = """/*
 #define __LIBSEL4_SYSCALL_H
 
 #include <autoconf.h>
+{% for condition, macro, count in optional %}
+#if {{condition}}
+#define {{macro}} {{count}}
+#else
+#define {{macro}} 0
+#endif /* {{condition}} */
+{%- endfor %}
 
 typedef enum {
-{%- set ns = namespace(syscall_number=-1) -%}
 {%- for condition, list in enum %}
    {%- if condition | length > 0 %}
 #if {{condition}}
    {%- endif %}
-   {%- for syscall in list %}
-    seL4_Sys{{syscall}} = {{ns.syscall_number}},
-    {%- set ns.syscall_number = ns.syscall_number - 1 -%}
+   {%- for syscall, number in list %}
+    seL4_Sys{{syscall}} = {{number}},
    {%- endfor %}
    {%- if condition | length > 0 %}
 #endif /* {{condition}} */
@@ -192,15 +210,16 @@ def parse_xml(xml_file):
         sys.exit(-1)
 
     configs = api[0].getElementsByTagName("config")
-    if len(configs) != 1:
-        print("Error: api element only supports 1 config element",
+    if len(configs) == 0 or len(configs[0].getAttribute("condition")) != 0:
+        print("Error: api element must start with an unconditional config element",
               file=sys.stderr)
         sys.exit(-1)
 
-    if len(configs[0].getAttribute("name")) != 0:
-        print("Error: api element config only supports an empty name",
-              file=sys.stderr)
-        sys.exit(-1)
+    for config in configs:
+        if len(config.getAttribute("name")) != 0:
+            print("Error: api element config only supports an empty name",
+                  file=sys.stderr)
+            sys.exit(-1)
 
     # debug elements are optional
     debug = doc.getElementsByTagName("debug")
@@ -220,18 +239,53 @@ def convert_to_assembler_format(s):
     return '_'.join(words).upper()
 
 
+def number_syscalls(api, debug, prefix):
+    """Number the syscalls from -1 downwards. The API syscalls form a single
+    range, so the numbers after a conditional group of API syscalls depend on
+    whether it is enabled. Each such group gets a macro holding its size when
+    enabled, which the later numbers are offset by. Debug syscalls keep their
+    numbers whether or not their group is enabled."""
+    optional = []
+    number = -1
+
+    def value(n):
+        return ' - '.join([str(n)] + [macro for (_, macro, _) in optional])
+
+    numbered_api = []
+    for condition, syscalls in api:
+        numbered_api.append((condition, [(syscall, value(number - i))
+                                         for i, syscall in enumerate(syscalls)]))
+        if condition:
+            optional.append((condition, '%s_OPTIONAL_API_%d' % (prefix, len(optional)),
+                             len(syscalls)))
+        else:
+            number -= len(syscalls)
+    syscall_min = value(number + 1)
+
+    numbered_debug = []
+    for condition, syscalls in debug:
+        numbered_debug.append((condition, [(syscall, value(number - i))
+                                           for i, syscall in enumerate(syscalls)]))
+        number -= len(syscalls)
+
+    return (numbered_api, numbered_debug, optional, syscall_min)
+
+
 def generate_kernel_file(kernel_header, api, debug):
+    (api, debug, optional, syscall_min) = number_syscalls(api, debug, 'SYSCALL')
     template = Environment(loader=BaseLoader, trim_blocks=False,
                            lstrip_blocks=False).from_string(KERNEL_HEADER_TEMPLATE)
     data = template.render({'assembler': api, 'enum': api + debug,
+                            'optional': optional, 'syscall_min': syscall_min,
                             'upper': convert_to_assembler_format})
     kernel_header.write(data)
 
 
-def generate_libsel4_file(libsel4_header, syscalls):
+def generate_libsel4_file(libsel4_header, api, debug):
+    (api, debug, optional, _) = number_syscalls(api, debug, 'SEL4_SYSCALL')
     template = Environment(loader=BaseLoader, trim_blocks=False,
                            lstrip_blocks=False).from_string(LIBSEL4_HEADER_TEMPLATE)
-    data = template.render({'enum': syscalls})
+    data = template.render({'enum': api + debug, 'optional': optional})
     libsel4_header.write(data)
 
 
@@ -246,5 +300,5 @@ if __name__ == "__main__":
         args.kernel_header.close()
 
     if (args.libsel4_header is not None):
-        generate_libsel4_file(args.libsel4_header, api + debug)
+        generate_libsel4_file(args.libsel4_header, api, debug)
         args.libsel4_header.close()